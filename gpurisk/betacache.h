@@ -0,0 +1,280 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <ppl.h>
+
+#include "betakey.h"
+#include "mapped_file.h"
+
+/* beta_cache memoizes beta results by the exact (x, a, b) bit pattern so that
+re-running a scenario grid only pays for the requests that have not been seen.
+
+The table is open addressed inside sets of beta_cache_ways slots.  A key can
+only live in the set its hash selects, so probes are bounded and no tombstones
+are needed.  When a set is full its CLOCK hand picks the victim.  Sets are
+guarded by a fixed stripe of mutexes, so lookups from parallel_for only contend
+when they land on the same stripe.
+
+A cache holds the results of one kernel.  Keep separate caches (and files) for
+P and Q or for different precision settings.  A persisted cache is opened with
+an identity naming what fills it, as in "nativebeta.cl incBetaQ", and a file
+written under any other identity is cleared rather than served. */
+
+const int beta_cache_ways = 8;
+const int beta_cache_stripes = 64;
+
+struct beta_cache_slot
+{
+	beta_key key;
+	double result;
+	unsigned int used;
+	unsigned int referenced;
+};
+
+struct beta_cache_header
+{
+	char magic[8];
+	unsigned __int64 sets;
+	unsigned __int64 ways;
+	unsigned __int64 slot_size;
+	unsigned __int64 hash_version;
+	unsigned __int64 identity_hash;
+	char identity[64];				// leading text of the identity, for a reader of the file
+};
+
+class beta_cache
+{
+	std::unique_ptr<io::mapped_file> file;
+	std::unique_ptr<beta_cache_slot[]> memory;
+	std::unique_ptr<unsigned char[]> hands;
+	beta_cache_slot *slots;
+	size_t sets;
+
+	std::mutex stripes[beta_cache_stripes];
+	std::atomic<unsigned __int64> hit_count, miss_count, eviction_count;
+
+	static size_t set_count(size_t capacity)
+	{
+		size_t count = 1;
+		while (count * beta_cache_ways < capacity) {
+			count <<= 1;
+		}
+		return count;
+	}
+
+	size_t set_of(const beta_key& key) const
+	{
+		return (size_t)(key.hash() & (sets - 1));
+	}
+
+	bool find(const beta_key& key, double& result)
+	{
+		size_t set = set_of(key);
+		beta_cache_slot *base = slots + set * beta_cache_ways;
+
+		std::lock_guard<std::mutex> lock(stripes[set % beta_cache_stripes]);
+		for (int i = 0; i < beta_cache_ways; i++)
+		{
+			if (base[i].used && base[i].key == key) {
+				base[i].referenced = 1;
+				result = base[i].result;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void store(const beta_key& key, double result)
+	{
+		size_t set = set_of(key);
+		beta_cache_slot *base = slots + set * beta_cache_ways;
+
+		std::lock_guard<std::mutex> lock(stripes[set % beta_cache_stripes]);
+
+		beta_cache_slot *target = nullptr;
+		for (int i = 0; i < beta_cache_ways; i++)
+		{
+			if (base[i].used && base[i].key == key) {
+				target = &base[i];
+				break;
+			}
+			if (!base[i].used && !target) {
+				target = &base[i];
+			}
+		}
+
+		if (!target) {
+			/* CLOCK: sweep the hand, clearing reference bits, until an unreferenced slot turns up */
+			unsigned char& hand = hands[set];
+			while (base[hand].referenced) {
+				base[hand].referenced = 0;
+				hand = (hand + 1) % beta_cache_ways;
+			}
+			target = &base[hand];
+			hand = (hand + 1) % beta_cache_ways;
+			eviction_count++;
+		}
+
+		target->key = key;
+		target->result = result;
+		target->used = 1;
+		target->referenced = 1;
+	}
+
+	// FNV-1a, so identities differing past the text kept in the header still differ
+	static unsigned __int64 identity_hash_of(const char *identity)
+	{
+		unsigned __int64 h = 0xCBF29CE484222325ULL;
+		for (; *identity; identity++) {
+			h ^= (unsigned char)*identity;
+			h *= 0x100000001B3ULL;
+		}
+		return h;
+	}
+
+	void attach(beta_cache_slot *_slots)
+	{
+		slots = _slots;
+		hands.reset(new unsigned char[sets]);
+		memset(hands.get(), 0, sets);
+		hit_count = miss_count = eviction_count = 0;
+	}
+
+public:
+
+	// an in memory cache holding at least capacity results
+	beta_cache(size_t capacity) : sets(set_count(capacity))
+	{
+		memory.reset(new beta_cache_slot[sets * beta_cache_ways]);
+		attach(memory.get());
+		clear();
+	}
+
+	/* a cache persisted in a memory mapped file, warm if the file was written by a
+	cache of the same shape, key hash and identity.  identity names the kernel,
+	tail and precision the results come from. */
+	beta_cache(size_t capacity, const char *file_name, const char *identity) : sets(set_count(capacity))
+	{
+		unsigned __int64 identity_hash = identity_hash_of(identity);
+
+		size_t length = sizeof(beta_cache_header) + sets * beta_cache_ways * sizeof(beta_cache_slot);
+		file.reset(new io::mapped_file(file_name, length));
+
+		beta_cache_header *header = (beta_cache_header *)file->get_data();
+		attach((beta_cache_slot *)(header + 1));
+
+		if (file->created() ||
+			memcmp(header->magic, "BETACACH", sizeof(header->magic)) != 0 ||
+			header->sets != sets ||
+			header->ways != beta_cache_ways ||
+			header->slot_size != sizeof(beta_cache_slot) ||
+			header->hash_version != beta_key::hash_version ||
+			header->identity_hash != identity_hash)
+		{
+			memcpy(header->magic, "BETACACH", sizeof(header->magic));
+			header->sets = sets;
+			header->ways = beta_cache_ways;
+			header->slot_size = sizeof(beta_cache_slot);
+			header->hash_version = beta_key::hash_version;
+			header->identity_hash = identity_hash;
+			memset(header->identity, 0, sizeof(header->identity));
+			strncpy(header->identity, identity, sizeof(header->identity) - 1);
+			clear();
+		}
+	}
+
+	beta_cache(const beta_cache&) = delete;
+	beta_cache& operator = (const beta_cache&) = delete;
+
+	bool lookup(const beta_request& request, double& result)
+	{
+		bool hit = find(beta_key::from(request), result);
+		if (hit) hit_count++; else miss_count++;
+		return hit;
+	}
+
+	void insert(const beta_request& request, double result)
+	{
+		store(beta_key::from(request), result);
+	}
+
+	/* Serves every request it can from the cache and hands the misses, packed,
+	to engine(requests, responses, count).  Engine results are scattered back into
+	request order and remembered.  Cached responses carry a threadid of -1. */
+
+	template <class Engine> void evaluate(const beta_request *requests, beta_response *responses, size_t count, Engine engine)
+	{
+		std::unique_ptr<unsigned char[]> hit(new unsigned char[count]);
+
+		concurrency::parallel_for((size_t)0, count, [&](size_t i)
+		{
+			double value;
+			hit[i] = find(beta_key::from(requests[i]), value);
+			if (hit[i]) {
+				responses[i].threadid = -1;
+				responses[i].result = value;
+			}
+		});
+
+		size_t miss_total = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			miss_total += !hit[i];
+		}
+
+		hit_count += count - miss_total;
+		miss_count += miss_total;
+
+		if (!miss_total) {
+			return;
+		}
+
+		std::unique_ptr<beta_request[]> miss_requests(new beta_request[miss_total]);
+		std::unique_ptr<beta_response[]> miss_responses(new beta_response[miss_total]);
+		std::unique_ptr<size_t[]> miss_index(new size_t[miss_total]);
+
+		for (size_t i = 0, j = 0; i < count; i++)
+		{
+			if (!hit[i]) {
+				miss_requests[j] = requests[i];
+				miss_index[j] = i;
+				j++;
+			}
+		}
+
+		engine(miss_requests.get(), miss_responses.get(), miss_total);
+
+		concurrency::parallel_for((size_t)0, miss_total, [&](size_t j)
+		{
+			responses[miss_index[j]] = miss_responses[j];
+			store(beta_key::from(miss_requests[j]), miss_responses[j].result);
+		});
+	}
+
+	void clear()
+	{
+		memset(slots, 0, sets * beta_cache_ways * sizeof(beta_cache_slot));
+		memset(hands.get(), 0, sets);
+	}
+
+	// writes a persisted cache back to its file, a no op in memory
+	void flush()
+	{
+		if (file) {
+			file->flush();
+		}
+	}
+
+	size_t capacity() const { return sets * beta_cache_ways; }
+	unsigned __int64 hits() const { return hit_count; }
+	unsigned __int64 misses() const { return miss_count; }
+	unsigned __int64 evictions() const { return eviction_count; }
+	double hit_ratio() const { return hit_count + miss_count ? (double)hit_count / (double)(hit_count + miss_count) : 0.0; }
+
+	void reset_counters()
+	{
+		hit_count = miss_count = eviction_count = 0;
+	}
+};
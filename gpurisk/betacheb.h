@@ -0,0 +1,363 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ppl.h>
+
+#include "openclhost.h"
+#include "file_data.h"
+
+/* Piecewise Chebyshev tables of I_x(a, b) for one (a, b), for parameter pairs
+that are asked for at millions of x.  A table is built once from the exact
+function and then answered by a Clenshaw sum per query, on the CPU or with
+incBetaCheb in chebbeta.cl.
+
+[0, 1] is cut at the mean a / (a + b).  Pieces left of it hold P, pieces
+right of it hold Q, so each side carries the smaller tail.  Where a < 1, P
+behaves as x^a at 0 and no polynomial follows it, so the pieces on that side
+hold P / x^a instead, which is smooth down to 0; the same goes for Q / (1-x)^b
+on the right when b < 1.  A piece that misses the tolerance at its check
+points is halved, so pieces crowd around the mode and the end points on their
+own.  Errors are absolute.
+
+On the CPU a query finds its piece through a uniform index over [0, 1]: cell
+j holds the piece containing j / cells, and the query steps on from there past
+the few pieces that start inside its cell, rather than bisecting the table. */
+
+const int beta_cheb_terms = 16;
+
+// the most cells in the CPU piece index, 256 KB of it
+const size_t beta_cheb_max_cells = 65536;
+
+// the CPU evaluates in blocks this many queries long, one parallel_for task each
+const size_t beta_cheb_block = 4096;
+
+// the host copy of beta_cheb_piece in chebbeta.cl
+struct beta_cheb_piece
+{
+	double lo, hi;
+	double power;		// the x^power or (1-x)^power factor, 0 for none
+	int upper;			// the piece holds Q rather than P
+	int reserved;
+	double c[beta_cheb_terms];
+};
+
+typedef struct beta_cheb_piece beta_cheb_piece;
+
+struct beta_cheb_header
+{
+	char magic[8];
+	double a, b;
+	double tolerance;
+	double max_error;
+	unsigned __int64 terms;
+	unsigned __int64 piece_size;
+	unsigned __int64 piece_count;
+};
+
+class beta_chebyshev
+{
+	typedef openClProgram<double, double> cheb_program;
+
+	double a, b;
+	double tolerance;
+	double max_error;
+	std::vector<beta_cheb_piece> pieces;
+	std::vector<unsigned int> index;	// the piece containing the start of each cell
+
+	int gpu_type;
+	std::unique_ptr<cheb_program> cheb_cl;
+
+	cheb_program& program()
+	{
+		if (!cheb_cl) {
+			io::file_data fd("chebbeta.cl");
+			cheb_cl.reset(new cheb_program(fd.get_data(), gpu_type));
+		}
+		return *cheb_cl;
+	}
+
+	static double factor(const beta_cheb_piece& piece, double x)
+	{
+		if (piece.power == 0.0) {
+			return 1.0;
+		}
+		return pow(piece.upper ? 1.0 - x : x, piece.power);
+	}
+
+	// P, or Q for an upper piece, from the exact P
+	template <class Exact> double target(const beta_cheb_piece& piece, double x, Exact& exact) const
+	{
+		double P = exact(x, a, b);
+		return piece.upper ? 1.0 - P : P;
+	}
+
+	// coefficients from the values at the beta_cheb_terms Chebyshev points of the piece
+	template <class Exact> void fit(beta_cheb_piece& piece, Exact& exact) const
+	{
+		const double pi = 3.14159265358979323846;
+		double values[beta_cheb_terms];
+		double mid = 0.5 * (piece.lo + piece.hi), half = 0.5 * (piece.hi - piece.lo);
+
+		for (int j = 0; j < beta_cheb_terms; j++)
+		{
+			double x = mid + half * cos(pi * (j + 0.5) / beta_cheb_terms);
+			values[j] = target(piece, x, exact) / factor(piece, x);
+		}
+
+		for (int k = 0; k < beta_cheb_terms; k++)
+		{
+			double sum = 0.0;
+			for (int j = 0; j < beta_cheb_terms; j++)
+			{
+				sum += values[j] * cos(pi * k * (j + 0.5) / beta_cheb_terms);
+			}
+			piece.c[k] = (k ? 2.0 : 1.0) * sum / beta_cheb_terms;
+		}
+	}
+
+	/* the largest error over count points spread across the piece, offset
+	by shift of a spacing so a second pass does not repeat the first */
+	template <class Exact> double check(const beta_cheb_piece& piece, Exact& exact, int count, double shift) const
+	{
+		double error = 0.0;
+
+		for (int i = 0; i < count; i++)
+		{
+			double x = piece.lo + (piece.hi - piece.lo) * (i + shift) / count;
+			if (x > 0.0 && x < 1.0) {
+				error = std::max(error, fabs(value(piece, x) - target(piece, x, exact)));
+			}
+		}
+		return error;
+	}
+
+	// P or Q as the piece holds it
+	static double value(const beta_cheb_piece& piece, double x)
+	{
+		double t = (2.0 * x - piece.lo - piece.hi) / (piece.hi - piece.lo);
+		double b1 = 0.0, b2 = 0.0;
+
+		for (int k = beta_cheb_terms - 1; k >= 1; k--)
+		{
+			double b0 = piece.c[k] + 2.0 * t * b1 - b2;
+			b2 = b1;
+			b1 = b0;
+		}
+
+		return factor(piece, x) * (piece.c[0] + t * b1 - b2);
+	}
+
+	/* Four cells a piece, as a power of 2, so most cells start in the piece
+	that covers them all and a query steps past at most a piece or two. */
+	void build_index()
+	{
+		size_t cells = 1;
+		while (cells < 4 * pieces.size() && cells < beta_cheb_max_cells) {
+			cells <<= 1;
+		}
+
+		index.resize(cells);
+		size_t piece = 0;
+		for (size_t j = 0; j < cells; j++)
+		{
+			double start = (double)j / (double)cells;
+			while (piece + 1 < pieces.size() && pieces[piece + 1].lo <= start) {
+				piece++;
+			}
+			index[j] = (unsigned int)piece;
+		}
+	}
+
+	// x in (0, 1)
+	const beta_cheb_piece& piece_of(double x) const
+	{
+		size_t cells = index.size();
+		size_t piece = index[std::min((size_t)(x * (double)cells), cells - 1)];
+		while (piece + 1 < pieces.size() && pieces[piece + 1].lo <= x) {
+			piece++;
+		}
+		return pieces[piece];
+	}
+
+public:
+
+	beta_chebyshev(int _gpu_type = CL_DEVICE_TYPE_GPU) : a(0.0), b(0.0), tolerance(0.0), max_error(0.0), gpu_type(_gpu_type)
+	{
+		;
+	}
+
+	/* Builds the table for (a, b) from exact(x, a, b), which must return P,
+	usually gsl::gsl_cdf_beta_P.  Pieces are halved until every one is within
+	a quarter of tolerance at 3 beta_cheb_terms check points, the margin
+	covering the error between them, or until max_pieces is reached.  A
+	second pass at points between those sets error_bound(), an estimate of what
+	the table achieved that is over tolerance when max_pieces ran out. */
+	template <class Exact> void build(double _a, double _b, Exact exact, double _tolerance = 1.0e-12, size_t max_pieces = 4096)
+	{
+		a = _a;
+		b = _b;
+		tolerance = _tolerance;
+		pieces.clear();
+
+		double mean = a / (a + b);
+		std::vector<beta_cheb_piece> pending;
+
+		beta_cheb_piece right = {};
+		right.lo = mean;
+		right.hi = 1.0;
+		right.upper = 1;
+		right.power = b < 1.0 ? b : 0.0;
+		pending.push_back(right);
+
+		beta_cheb_piece left = {};
+		left.lo = 0.0;
+		left.hi = mean;
+		left.power = a < 1.0 ? a : 0.0;
+		pending.push_back(left);
+
+		// depth first, left half on top, so pieces come out in x order
+		while (!pending.empty())
+		{
+			beta_cheb_piece piece = pending.back();
+			pending.pop_back();
+
+			fit(piece, exact);
+
+			bool narrow = piece.hi - piece.lo <= 1.0e-12 * std::max(piece.hi, 1.0e-300);
+			if (narrow || pieces.size() + pending.size() + 2 > max_pieces || check(piece, exact, 3 * beta_cheb_terms, 0.5) <= 0.25 * tolerance) {
+				pieces.push_back(piece);
+				continue;
+			}
+
+			beta_cheb_piece upper_half = piece, lower_half = piece;
+			lower_half.hi = upper_half.lo = 0.5 * (piece.lo + piece.hi);
+			pending.push_back(upper_half);
+			pending.push_back(lower_half);
+		}
+
+		max_error = 0.0;
+		for (size_t i = 0; i < pieces.size(); i++)
+		{
+			max_error = std::max(max_error, check(pieces[i], exact, 2 * beta_cheb_terms, 0.381966));
+		}
+		build_index();
+	}
+
+	// reads a table saved for the same (a, b) and tolerance, false if there is none
+	bool load(const char *file_name, double _a, double _b, double _tolerance)
+	{
+		FILE *fp = fopen(file_name, "rb");
+		if (!fp) {
+			return false;
+		}
+
+		beta_cheb_header header;
+		bool match = fread(&header, sizeof(header), 1, fp) == 1 &&
+			memcmp(header.magic, "BETACHEB", sizeof(header.magic)) == 0 &&
+			header.a == _a && header.b == _b && header.tolerance == _tolerance &&
+			header.terms == beta_cheb_terms &&
+			header.piece_size == sizeof(beta_cheb_piece) &&
+			header.piece_count > 0;
+
+		if (match) {
+			std::vector<beta_cheb_piece> loaded((size_t)header.piece_count);
+			match = fread(loaded.data(), sizeof(beta_cheb_piece), loaded.size(), fp) == loaded.size();
+			if (match) {
+				a = header.a;
+				b = header.b;
+				tolerance = header.tolerance;
+				max_error = header.max_error;
+				pieces.swap(loaded);
+				build_index();
+			}
+		}
+
+		fclose(fp);
+		return match;
+	}
+
+	void save(const char *file_name) const
+	{
+		FILE *fp = fopen(file_name, "wb");
+		if (!fp) {
+			throw std::exception("Couldn't write Chebyshev table.");
+		}
+
+		beta_cheb_header header = {};
+		memcpy(header.magic, "BETACHEB", sizeof(header.magic));
+		header.a = a;
+		header.b = b;
+		header.tolerance = tolerance;
+		header.max_error = max_error;
+		header.terms = beta_cheb_terms;
+		header.piece_size = sizeof(beta_cheb_piece);
+		header.piece_count = pieces.size();
+
+		bool written = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+			fwrite(pieces.data(), sizeof(beta_cheb_piece), pieces.size(), fp) == pieces.size();
+		fclose(fp);
+
+		if (!written) {
+			throw std::exception("Couldn't write Chebyshev table.");
+		}
+	}
+
+	// the table from file_name when it holds this (a, b), otherwise built and saved there
+	template <class Exact> void open(const char *file_name, double _a, double _b, Exact exact, double _tolerance = 1.0e-12)
+	{
+		if (!load(file_name, _a, _b, _tolerance)) {
+			build(_a, _b, exact, _tolerance);
+			save(file_name);
+		}
+	}
+
+	double P(double x) const
+	{
+		if (x <= 0.0) return 0.0;
+		if (x >= 1.0) return 1.0;
+		const beta_cheb_piece& piece = piece_of(x);
+		double v = value(piece, x);
+		return piece.upper ? 1.0 - v : v;
+	}
+
+	double Q(double x) const
+	{
+		if (x <= 0.0) return 1.0;
+		if (x >= 1.0) return 0.0;
+		const beta_cheb_piece& piece = piece_of(x);
+		double v = value(piece, x);
+		return piece.upper ? v : 1.0 - v;
+	}
+
+	/* P, or Q when upper is set, for count x on the CPU.  Each query sums the
+	coefficients of its own piece, a gather the compiler does not vectorize,
+	so the work is split across cores in blocks instead. */
+	void evaluate(const double *x, double *values, size_t count, bool upper) const
+	{
+		size_t blocks = (count + beta_cheb_block - 1) / beta_cheb_block;
+		concurrency::parallel_for((size_t)0, blocks, [&](size_t block)
+		{
+			size_t end = std::min(count, (block + 1) * beta_cheb_block);
+			for (size_t i = block * beta_cheb_block; i < end; i++)
+			{
+				values[i] = upper ? Q(x[i]) : P(x[i]);
+			}
+		});
+	}
+
+	// as evaluate, with incBetaCheb
+	void evaluateGpu(double *x, double *values, size_t count, bool upper)
+	{
+		if (count) {
+			program().RunKernel("incBetaCheb", x, values, count, 1, openClIn(pieces.data(), pieces.size()), (int)pieces.size(), (int)upper);
+		}
+	}
+
+	size_t piece_count() const { return pieces.size(); }
+	// the largest error seen at check points between the fitting ones, not a proven bound
+	double error_bound() const { return max_error; }
+};
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <ppl.h>
+
+#include "betakey.h"
+
+/* beta_dedup collapses exact duplicate (x, a, b) requests in a batch before it
+is dispatched, so the kernel only sees the unique set and the results are
+scattered back through an index map.
+
+Keys are hashed in parallel and the (hash, index) pairs are put in order with
+a parallel LSD radix sort; equal hashes are then checked against the full key
+so a collision can never merge two different requests.
+
+Sorting is not free, so the stage first estimates the duplicate ratio from
+the keys whose hash falls in a 1 / 2^sample_shift slice of the hash space.
+All copies of a key share a hash, so the slice sees the batch's duplicate
+ratio without the undercount a positional sample would have.  When the
+estimate is under min_duplicate_ratio the batch goes straight to the engine. */
+
+struct beta_dedup_stats
+{
+	size_t count;
+	size_t unique;
+	double sampled_ratio;
+	bool bypassed;
+};
+
+class beta_dedup
+{
+	double min_duplicate_ratio;
+	int sample_shift;
+	beta_dedup_stats stats;
+
+	static const int radix_bits = 8;
+	static const int radix_buckets = 1 << radix_bits;
+	static const size_t min_block = 65536;
+
+	struct hashed_index
+	{
+		unsigned __int64 hash;
+		size_t index;
+	};
+
+	// stable parallel LSD radix sort on hash, tmp is scratch of the same size, returns whichever holds the result
+	static hashed_index *radix_sort(hashed_index *items, hashed_index *tmp, size_t count)
+	{
+		size_t blocks = std::max<size_t>(1, std::min<size_t>(64, count / min_block));
+		size_t block_size = (count + blocks - 1) / blocks;
+
+		std::vector<size_t> histogram(blocks * radix_buckets);
+
+		for (int shift = 0; shift < 64; shift += radix_bits)
+		{
+			std::fill(histogram.begin(), histogram.end(), 0);
+
+			concurrency::parallel_for((size_t)0, blocks, [&](size_t block)
+			{
+				size_t *h = &histogram[block * radix_buckets];
+				size_t end = std::min(count, (block + 1) * block_size);
+				for (size_t i = block * block_size; i < end; i++)
+				{
+					h[(items[i].hash >> shift) & (radix_buckets - 1)]++;
+				}
+			});
+
+			// a digit every key shares does not reorder anything
+			bool trivial = false;
+			for (int digit = 0; digit < radix_buckets && !trivial; digit++)
+			{
+				size_t total = 0;
+				for (size_t block = 0; block < blocks; block++)
+				{
+					total += histogram[block * radix_buckets + digit];
+				}
+				trivial = total == count;
+			}
+			if (trivial) {
+				continue;
+			}
+
+			// exclusive prefix in (digit, block) order keeps the sort stable
+			size_t offset = 0;
+			for (int digit = 0; digit < radix_buckets; digit++)
+			{
+				for (size_t block = 0; block < blocks; block++)
+				{
+					size_t& h = histogram[block * radix_buckets + digit];
+					size_t n = h;
+					h = offset;
+					offset += n;
+				}
+			}
+
+			concurrency::parallel_for((size_t)0, blocks, [&](size_t block)
+			{
+				size_t *h = &histogram[block * radix_buckets];
+				size_t end = std::min(count, (block + 1) * block_size);
+				for (size_t i = block * block_size; i < end; i++)
+				{
+					tmp[h[(items[i].hash >> shift) & (radix_buckets - 1)]++] = items[i];
+				}
+			});
+
+			std::swap(items, tmp);
+		}
+
+		return items;
+	}
+
+public:
+
+	beta_dedup(double _min_duplicate_ratio = 0.1, int _sample_shift = 6) :
+		min_duplicate_ratio(_min_duplicate_ratio),
+		sample_shift(_sample_shift)
+	{
+		stats.count = stats.unique = 0;
+		stats.sampled_ratio = 0.0;
+		stats.bypassed = false;
+	}
+
+	const beta_dedup_stats& last() const
+	{
+		return stats;
+	}
+
+	/* Dispatches the unique requests to engine(requests, responses, count) and
+	fills responses for the whole batch in request order. */
+
+	template <class Engine> void evaluate(const beta_request *requests, beta_response *responses, size_t count, Engine engine)
+	{
+		stats.count = count;
+		stats.unique = count;
+		stats.sampled_ratio = 0.0;
+		stats.bypassed = true;
+
+		// small batches are sampled whole
+		int shift = count < ((size_t)4096 << sample_shift) ? 0 : sample_shift;
+
+		/* The sample is taken in parallel blocks before anything the size of the
+		batch is allocated, so a batch that is bypassed costs one hashing pass. */
+		size_t blocks = std::max<size_t>(1, std::min<size_t>(64, count / min_block));
+		size_t block_size = (count + blocks - 1) / blocks;
+		std::vector<std::vector<unsigned __int64>> block_samples(blocks);
+
+		concurrency::parallel_for((size_t)0, blocks, [&](size_t block)
+		{
+			std::vector<unsigned __int64>& local = block_samples[block];
+			size_t end = std::min(count, (block + 1) * block_size);
+			for (size_t i = block * block_size; i < end; i++)
+			{
+				unsigned __int64 hash = beta_key::from(requests[i]).hash();
+				if (shift == 0 || (hash >> (64 - shift)) == 0) {
+					local.push_back(hash);
+				}
+			}
+		});
+
+		std::vector<unsigned __int64> sample;
+		for (auto& local : block_samples)
+		{
+			sample.insert(sample.end(), local.begin(), local.end());
+		}
+
+		if (sample.size() > 1) {
+			std::sort(sample.begin(), sample.end());
+			size_t distinct = std::unique(sample.begin(), sample.end()) - sample.begin();
+			stats.sampled_ratio = 1.0 - (double)distinct / (double)sample.size();
+		}
+
+		if (stats.sampled_ratio < min_duplicate_ratio) {
+			// engines take a writable pointer for clCreateBuffer, they do not modify the requests
+			engine(const_cast<beta_request *>(requests), responses, count);
+			return;
+		}
+
+		stats.bypassed = false;
+
+		// hashed again in full, which is cheap next to the sort
+		std::unique_ptr<hashed_index[]> items(new hashed_index[count]), scratch(new hashed_index[count]);
+
+		concurrency::parallel_for((size_t)0, count, [&](size_t i)
+		{
+			items[i].hash = beta_key::from(requests[i]).hash();
+			items[i].index = i;
+		});
+
+		hashed_index *sorted = radix_sort(items.get(), scratch.get(), count);
+
+		std::vector<beta_request> unique_requests;
+		std::unique_ptr<size_t[]> map(new size_t[count]);
+		unique_requests.reserve((size_t)(count * (1.0 - stats.sampled_ratio)) + 1024);
+
+		for (size_t run = 0; run < count;)
+		{
+			size_t run_end = run + 1;
+			while (run_end < count && sorted[run_end].hash == sorted[run].hash) {
+				run_end++;
+			}
+
+			// almost always one key per hash, collisions get their own unique entries
+			size_t first_unique = unique_requests.size();
+			for (size_t i = run; i < run_end; i++)
+			{
+				const beta_request& request = requests[sorted[i].index];
+				beta_key key = beta_key::from(request);
+				size_t u = first_unique;
+				while (u < unique_requests.size() && beta_key::from(unique_requests[u]) != key) {
+					u++;
+				}
+				if (u == unique_requests.size()) {
+					unique_requests.push_back(request);
+				}
+				map[sorted[i].index] = u;
+			}
+
+			run = run_end;
+		}
+
+		stats.unique = unique_requests.size();
+
+		std::unique_ptr<beta_response[]> unique_responses(new beta_response[stats.unique]);
+
+		engine(unique_requests.data(), unique_responses.get(), stats.unique);
+
+		concurrency::parallel_for((size_t)0, count, [&](size_t i)
+		{
+			responses[i] = unique_responses[map[i]];
+		});
+	}
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "openclhost.h"
+#include "file_data.h"
+#include "gslsource.h"
+
+/* The regimes gsl_cdf_beta_classify_cl in gslreduce.cl puts requests in, as
+numbered there. */
+enum beta_regime
+{
+	beta_regime_edge,		// x outside (0, 1), no evaluation
+	beta_regime_direct,		// the continued fraction on x
+	beta_regime_reflected,	// the continued fraction on 1 - x
+	beta_regime_count
+};
+
+/* beta_regime_graph runs Q and its aggregate over batches of one size as an
+openClGraph on openClReduceSource, gslbeta.cl and gslreduce.cl:
+
+	zero counts, write requests, write weights
+	classify					then read regime counts
+	Q edge, Q direct, Q reflected, side by side
+	scatter						then read responses
+	aggregate					then read partials
+
+The three regime launches wait only on classify, so they overlap on the
+device, and the whole batch is queued without the host waiting on any stage.
+gamma_engine sorts by regime on the host and launches once; here the sort
+is on the device and stays there.  The datasets and the graph are made once
+by the constructor and every batch reuses them, so a batch costs the copies
+and the launches and nothing else.
+
+Results are those of gsl_cdf_beta_Q_cl, and the aggregate that of
+beta_tiers::reduceQ, bit for bit. */
+class beta_regime_graph
+{
+	typedef openClProgram<beta_request, beta_response> graph_program;
+	typedef openClGraph<beta_request, beta_response> regime_graph;
+
+	size_t count;
+	size_t groups;
+
+	// declared in the order they are made, so the graph goes first and the program last
+	std::unique_ptr<graph_program> program;
+	openClDataset<beta_request> requests;
+	openClDataset<unsigned int> member;
+	openClDataset<unsigned int> counts;
+	openClDataset<double> value;
+	openClDataset<beta_response> responses;
+	openClDataset<double> weights;
+	openClDataset<beta_aggregate> partials;
+	std::unique_ptr<regime_graph> graph;
+
+	unsigned int zero_counts[beta_regime_count];
+	unsigned int regime_counts[beta_regime_count];
+	std::vector<beta_aggregate> partial_results;
+
+	size_t write_requests;
+	size_t write_weights;
+	size_t aggregate;
+	size_t read_responses;
+
+public:
+
+	// a graph for batches of _count requests
+	beta_regime_graph(size_t _count, int _gpu_type = CL_DEVICE_TYPE_GPU) :
+		count(_count)
+	{
+		if (!count) {
+			throw std::exception("beta_regime_graph needs batches of at least one request.");
+		}
+
+		gsl_source gsl;
+		io::file_data reduce("gslreduce.cl");
+		const char *sources[3] = { openClReduceSource, gsl.get_data(), reduce.get_data() };
+		program.reset(new graph_program(sources, 3, _gpu_type));
+
+		// the aggregate in the groups RunReduce gives gsl_cdf_beta_Q_reduce_cl, so the sums go in the same order
+		size_t aggregate_group = program->GetReduceGroup("gsl_cdf_beta_aggregate_cl");
+		size_t classify_group = program->GetReduceGroup("gsl_cdf_beta_classify_cl");
+		groups = program->GetReduceGroups(count, aggregate_group);
+
+		std::fill(zero_counts, zero_counts + beta_regime_count, 0);
+		std::fill(regime_counts, regime_counts + beta_regime_count, 0);
+		partial_results.assign(groups, beta_aggregate_identity());
+
+		requests = program->Allocate<beta_request>(count);
+		member = program->Allocate<unsigned int>(count * beta_regime_count);
+		counts = program->Allocate<unsigned int>(beta_regime_count);
+		value = program->Allocate<double>(count * beta_regime_count);
+		responses = program->Allocate<beta_response>(count);
+		weights = program->Allocate<double>(count);
+		partials = program->Allocate<beta_aggregate>(groups);
+
+		graph.reset(new regime_graph(*program));
+
+		cl_ulong batch = count;
+		size_t classify_items = (count + classify_group - 1) / classify_group * classify_group;
+
+		size_t zero = graph->Write(counts, zero_counts);
+		write_requests = graph->Write(requests, (const beta_request *)NULL);
+		write_weights = graph->Write(weights, (const double *)NULL);
+
+		size_t classify = graph->Kernel("gsl_cdf_beta_classify_cl", classify_items, classify_group, { zero, write_requests },
+			requests, member, counts, batch, batch);
+
+		size_t regimes[beta_regime_count];
+		for (int r = 0; r < beta_regime_count; r++)
+		{
+			regimes[r] = graph->Kernel("gsl_cdf_beta_Q_regime_cl", count, 0, { classify },
+				requests, member, counts, value, r, batch);
+		}
+
+		size_t scatter = graph->Kernel("gsl_cdf_beta_scatter_cl", count * beta_regime_count, 0, { regimes[beta_regime_edge], regimes[beta_regime_direct], regimes[beta_regime_reflected] },
+			member, counts, value, responses, batch);
+
+		aggregate = graph->Kernel("gsl_cdf_beta_aggregate_cl", groups * aggregate_group, aggregate_group, { scatter, write_weights },
+			responses, partials, batch, weights, 0, 1.0);
+
+		read_responses = graph->Read(responses, (beta_response *)NULL, { scatter });
+		graph->Read(counts, regime_counts, { classify });
+		graph->Read(partials, partial_results.data(), { aggregate });
+	}
+
+	/* Q of a batch of the size the graph was made for, into results, and its
+	aggregate as beta_tiers::reduceQ gives it.  results may be NULL when only
+	the aggregate is wanted, and exposures when the requests are not weighted. */
+	beta_aggregate evaluate(const beta_request *batch, beta_response *results, const double *exposures = NULL, double threshold = 1.0)
+	{
+		graph->SetData(write_requests, batch);
+		graph->SetData(write_weights, exposures);
+		graph->SetData(read_responses, results);
+		graph->SetArg(aggregate, 4, (int)(exposures != NULL));
+		graph->SetArg(aggregate, 5, threshold);
+		graph->Run();
+
+		beta_aggregate result = beta_aggregate_identity();
+		for (auto& partial : partial_results)
+		{
+			result = beta_aggregate_combine(result, partial);
+		}
+		return result;
+	}
+
+	size_t batch_size() const
+	{
+		return count;
+	}
+
+	// how many command queues the graph is spread over, 1 when the device has an out of order one
+	size_t lane_count() const
+	{
+		return graph->GetLaneCount();
+	}
+
+	// how many requests of the last batch fell in each regime
+	size_t regime_count(beta_regime regime) const
+	{
+		return regime_counts[regime];
+	}
+};
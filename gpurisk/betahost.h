@@ -0,0 +1,688 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "openclhost.h"
+#include "file_data.h"
+#include "gslsource.h"
+
+/* Precision tiers for the beta Q kernels.  Each tier is its own program,
+built and cached the first time a batch asks for it.
+
+	beta_fast		fastbeta.cl, single precision, -cl-fast-relaxed-math
+	beta_standard	nativebeta.cl incBetaQTol, the Lentz stop test given per batch
+	beta_exact		gslbeta.cl gsl_cdf_beta_Q_cl, the gslport.h algorithm
+
+The bounds below are absolute errors against gslport.h for 0.01 <= a, b <= 1000
+and are what riskPrecisionTest checks.  Screening runs use beta_fast,
+regulatory runs beta_exact. */
+
+enum beta_precision
+{
+	beta_fast,
+	beta_standard,
+	beta_exact,
+	beta_precision_count
+};
+
+inline double beta_precision_bound(beta_precision precision, double tolerance = 1.0e-8)
+{
+	switch (precision)
+	{
+	case beta_fast:
+		return 1.0e-3;
+	case beta_standard:
+		// Lentz stops on the relative change of one step, the remaining tail is ~15x that
+		return 20.0 * (tolerance > 1.0e-12 ? tolerance : 1.0e-12);
+	default:
+		return 1.0e-12;
+	}
+}
+
+// a Q with its estimated absolute error, as incBetaQEstimate writes it
+struct beta_estimate
+{
+	int threadid;
+	double result;
+	double err;
+};
+
+typedef struct beta_estimate beta_estimate;
+
+/* One parameter sweep for gsl_cdf_beta_sweep_cl: I_x(a+k, b), or I_x(a, b+k)
+when sweep_b is set, for k = 0 .. count-1, written to results[offset ...].
+upper selects Q rather than P.  offset is 64 bit so results may pass 2^31
+doubles; reserved pads it to 8 bytes as the kernel's ulong is. */
+struct beta_sweep_request
+{
+	double x, a, b;
+	int count;
+	int sweep_b;
+	int upper;
+	int reserved;
+	unsigned __int64 offset;
+};
+
+typedef struct beta_sweep_request beta_sweep_request;
+
+// the density, P, Q and their logs for one request, the host copy of gsl_cdf_beta_fused_result
+struct beta_fused
+{
+	double pdf;
+	double P;
+	double Q;
+	double ln_P;
+	double ln_Q;
+};
+
+typedef struct beta_fused beta_fused;
+
+/* A quantile for gsl_cdf_beta_Pinv_cl and gsl_cdf_beta_Qinv_cl: the x at
+which P (or Q) reaches p. */
+struct beta_quantile_request
+{
+	double p, a, b;
+};
+
+typedef struct beta_quantile_request beta_quantile_request;
+
+// Student-t and F requests, the host copies of gsl_cdf_tdist_request and gsl_cdf_fdist_request
+struct tdist_request
+{
+	double x, nu;
+};
+
+typedef struct tdist_request tdist_request;
+
+struct fdist_request
+{
+	double x, nu1, nu2;
+};
+
+typedef struct fdist_request fdist_request;
+
+/* Discrete requests for gsldiscrete.cl.  binomial_request is k successes in n
+trials of probability p, or k failures before the n-th success for the
+negative binomial; beta_binomial_request is k defaults among n names whose
+default probability is beta(alpha, beta). */
+struct binomial_request
+{
+	double p;
+	int k, n;
+};
+
+typedef struct binomial_request binomial_request;
+
+struct beta_binomial_request
+{
+	double alpha, beta;
+	int k, n;
+};
+
+typedef struct beta_binomial_request beta_binomial_request;
+
+/* Which probability a t or F batch returns.  beta_two_sided is the p-value
+of a two sided test: P(|T| > |x|) for the t, twice the smaller tail for the F. */
+enum beta_tail
+{
+	beta_lower,
+	beta_upper,
+	beta_two_sided
+};
+
+/* The grid description the *Pairs and *Product kernels expand on the device:
+x_count points from x_start in steps of x_step, against a_count a values. */
+struct beta_grid
+{
+	double x_start, x_step;
+	int x_count;
+	int a_count;
+};
+
+typedef struct beta_grid beta_grid;
+
+/* The per group partial the *_reduce_cl kernels in gslreduce.cl write, and
+what beta_tiers::reduceQ folds them into.  argmin and argmax are request
+indices, -1 for an empty batch.  count is the number of results above the
+threshold. */
+struct beta_aggregate
+{
+	double sum;
+	double weighted_sum;
+	double min;
+	double max;
+	__int64 argmin;
+	__int64 argmax;
+	__int64 count;
+};
+
+typedef struct beta_aggregate beta_aggregate;
+
+inline beta_aggregate beta_aggregate_identity()
+{
+	beta_aggregate identity = { 0.0, 0.0, INFINITY, -INFINITY, -1, -1, 0 };
+	return identity;
+}
+
+// folds two aggregates, ties go to the lower index as they do on the device
+inline beta_aggregate beta_aggregate_combine(const beta_aggregate& left, const beta_aggregate& right)
+{
+	beta_aggregate result;
+	result.sum = left.sum + right.sum;
+	result.weighted_sum = left.weighted_sum + right.weighted_sum;
+	result.count = left.count + right.count;
+
+	bool right_min = right.min < left.min || (right.min == left.min && (unsigned __int64)right.argmin < (unsigned __int64)left.argmin);
+	result.min = right_min ? right.min : left.min;
+	result.argmin = right_min ? right.argmin : left.argmin;
+
+	bool right_max = right.max > left.max || (right.max == left.max && (unsigned __int64)right.argmax < (unsigned __int64)left.argmax);
+	result.max = right_max ? right.max : left.max;
+	result.argmax = right_max ? right.argmax : left.argmax;
+	return result;
+}
+
+// a result that passed beta_tiers::filterQ, the host copy of gsl_cdf_beta_hit
+struct beta_hit
+{
+	__int64 index;
+	double value;
+};
+
+typedef struct beta_hit beta_hit;
+
+/* The status beta_tiers::evaluateChecked gives each request, the GSL error
+number gsl_cdf_beta_status returns for it. */
+enum beta_status
+{
+	beta_ok = 0,			// GSL_SUCCESS
+	beta_domain = 1,		// GSL_EDOM, a or b not positive or x NaN
+	beta_maxiter = 11,		// GSL_EMAXITER, the continued fraction gave up
+	beta_underflow = 15,	// GSL_EUNDRFLW, a tail inside (0, 1) came out 0
+	beta_status_count = 33	// GSL error numbers run to GSL_EOF, 32
+};
+
+// a request that did not succeed, the host copy of gsl_cdf_beta_failure
+struct beta_failure
+{
+	__int64 index;
+	int status;
+	int reserved;
+};
+
+typedef struct beta_failure beta_failure;
+
+/* The counts from a checked batch.  by_status[s] is how many requests ended
+with status s, beta_ok included, and failed is all but the beta_ok ones.
+truncated is set when there were more failures than the list had room for. */
+struct beta_status_summary
+{
+	size_t count;
+	size_t failed;
+	size_t by_status[beta_status_count];
+	bool truncated;
+};
+
+class beta_tiers
+{
+	typedef openClProgram<beta_request, beta_response> beta_program;
+
+	int gpu_type;
+	std::unique_ptr<beta_program> programs[beta_precision_count];
+	std::unique_ptr<beta_program> reduce_program;
+	std::unique_ptr<beta_program> discrete_program;
+	std::unique_ptr<beta_program> retry_program;
+	int retry_iter;
+
+	// openClReduceSource, gslbeta.cl and gslreduce.cl built as one program
+	beta_program& reducer()
+	{
+		if (!reduce_program) {
+			gsl_source gsl;
+			io::file_data reduce("gslreduce.cl");
+			const char *sources[3] = { openClReduceSource, gsl.get_data(), reduce.get_data() };
+			reduce_program.reset(new beta_program(sources, 3, gpu_type));
+		}
+		return *reduce_program;
+	}
+
+	// gslbeta.cl and gsldiscrete.cl built as one program
+	beta_program& discrete()
+	{
+		if (!discrete_program) {
+			gsl_source gsl;
+			io::file_data dist("gsldiscrete.cl");
+			const char *sources[2] = { gsl.get_data(), dist.get_data() };
+			discrete_program.reset(new beta_program(sources, 2, gpu_type));
+		}
+		return *discrete_program;
+	}
+
+	beta_program& program(beta_precision precision)
+	{
+		if (!programs[precision]) {
+			switch (precision)
+			{
+			case beta_fast:
+			{
+				io::file_data fd("fastbeta.cl");
+				programs[precision].reset(new beta_program(fd.get_data(), gpu_type, "-cl-fast-relaxed-math"));
+				break;
+			}
+			case beta_standard:
+			{
+				io::file_data fd("nativebeta.cl");
+				programs[precision].reset(new beta_program(fd.get_data(), gpu_type));
+				break;
+			}
+			default:
+			{
+				gsl_source fd;
+				programs[precision].reset(new beta_program(fd.get_data(), gpu_type));
+				break;
+			}
+			}
+		}
+		return *programs[precision];
+	}
+
+	// the exact tier built with a continued fraction that may run max_iter iterations
+	beta_program& retrier(int max_iter)
+	{
+		if (!retry_program || retry_iter != max_iter) {
+			char options[64];
+			sprintf(options, "-DGSL_CORE_CF_MAX_ITER=%d", max_iter);
+			gsl_source gsl;
+			retry_program.reset(new beta_program(gsl.get_data(), gpu_type, options));
+			retry_iter = max_iter;
+		}
+		return *retry_program;
+	}
+
+	beta_status_summary runChecked(beta_program& checked, beta_request *requests, beta_response *responses, size_t count, bool upper,
+		std::vector<beta_failure>& failures, unsigned char *status, size_t max_failures)
+	{
+		beta_status_summary summary = {};
+		summary.count = count;
+		if (!count) {
+			return summary;
+		}
+
+		// the last slot counts every failure, listed or not
+		std::vector<cl_uint> tally(beta_status_count + 1, 0);
+		std::vector<beta_failure> listed(std::max<size_t>(max_failures, 1));
+		unsigned char unused = 0;
+		int per_request = status != NULL;
+
+		const char *kernel = upper ? "gsl_cdf_beta_Q_status_cl" : "gsl_cdf_beta_P_status_cl";
+		if (per_request) {
+			checked.RunKernel(kernel, requests, responses, count, 1, openClOut(tally.data(), tally.size()), openClOut(listed.data(), listed.size()), (cl_uint)max_failures,
+				openClOutEach(status), per_request, openClFirst());
+		}
+		else {
+			checked.RunKernel(kernel, requests, responses, count, 1, openClOut(tally.data(), tally.size()), openClOut(listed.data(), listed.size()), (cl_uint)max_failures,
+				openClOut(&unused, 1), per_request, openClFirst());
+		}
+
+		summary.failed = tally[beta_status_count];
+		summary.by_status[beta_ok] = count - summary.failed;
+		for (int s = 1; s < beta_status_count; s++)
+		{
+			summary.by_status[s] = tally[s];
+		}
+		summary.truncated = summary.failed > max_failures;
+
+		size_t first = failures.size();
+		failures.insert(failures.end(), listed.begin(), listed.begin() + std::min(summary.failed, max_failures));
+		std::sort(failures.begin() + first, failures.end(), [](const beta_failure& left, const beta_failure& right)
+		{
+			return left.index < right.index;
+		});
+		return summary;
+	}
+
+	static const char *grid_kernel(beta_precision precision, bool product)
+	{
+		switch (precision)
+		{
+		case beta_fast:
+			return product ? "incBetaQFastProduct" : "incBetaQFastPairs";
+		case beta_standard:
+			return product ? "incBetaQTolProduct" : "incBetaQTolPairs";
+		default:
+			return product ? "gsl_cdf_beta_Q_product_cl" : "gsl_cdf_beta_Q_pairs_cl";
+		}
+	}
+
+	/* Launches are cut along the last grid dimension, pairs or b values, so
+	no launch holds more than max_points results on the device. */
+	void evaluateGrid(beta_precision precision, bool product, double x_start, double x_step, int x_count,
+		const double *a_values, const double *b_values, int a_count, int last_count, double *results, double tolerance, size_t max_points)
+	{
+		size_t row = (size_t)x_count * (product ? a_count : 1);
+		int slab = (int)std::max<size_t>(1, std::min<size_t>(last_count, max_points / row));
+
+		beta_grid grid;
+		grid.x_start = x_start;
+		grid.x_step = x_step;
+		grid.x_count = x_count;
+		grid.a_count = product ? a_count : 1;
+
+		for (int first = 0; first < last_count; first += slab)
+		{
+			int n = std::min(slab, last_count - first);
+			size_t global_size[3] = { (size_t)x_count, product ? (size_t)a_count : (size_t)n, (size_t)n };
+			cl_uint work_dim = product ? 3 : 2;
+			const double *a_slab = product ? a_values : a_values + first;
+			size_t a_slab_count = product ? a_count : n;
+
+			if (precision == beta_standard) {
+				program(precision).RunKernelRange(grid_kernel(precision, product), &grid, 1, results + row * first, row * n, work_dim, global_size, NULL,
+					openClIn(a_slab, a_slab_count), openClIn(b_values + first, n), tolerance);
+			}
+			else {
+				program(precision).RunKernelRange(grid_kernel(precision, product), &grid, 1, results + row * first, row * n, work_dim, global_size, NULL,
+					openClIn(a_slab, a_slab_count), openClIn(b_values + first, n));
+			}
+		}
+	}
+
+public:
+
+	beta_tiers(int _gpu_type = CL_DEVICE_TYPE_GPU) : gpu_type(_gpu_type), retry_iter(0)
+	{
+		;
+	}
+
+	// builds a tier ahead of its first batch so the build is not timed with it
+	void prepare(beta_precision precision)
+	{
+		program(precision);
+	}
+
+	/* Q for a batch at the given tier.  tolerance is only read by beta_standard. */
+	void evaluateQ(beta_precision precision, beta_request *requests, beta_response *responses, size_t count, double tolerance = 1.0e-8)
+	{
+		switch (precision)
+		{
+		case beta_fast:
+			program(precision).RunKernel("incBetaQFast", requests, responses, count, 1);
+			break;
+		case beta_standard:
+			program(precision).RunKernel("incBetaQTol", requests, responses, count, 1, tolerance);
+			break;
+		default:
+			program(precision).RunKernel("gsl_cdf_beta_Q_cl", requests, responses, count, 1);
+			break;
+		}
+	}
+
+	/* P, or Q when upper is set, on the exact tier with a status for each
+	request.  The device counts failures by status and lists up to
+	max_failures of them, which are appended to failures in request order,
+	so finding what to retry does not mean scanning every response.
+	status, when not NULL, gets every request's status as a byte;
+	max_failures 0 keeps only the counts.  When the summary is truncated the
+	list is incomplete and only status has the rest. */
+	beta_status_summary evaluateChecked(beta_request *requests, beta_response *responses, size_t count, bool upper,
+		std::vector<beta_failure>& failures, unsigned char *status = NULL, size_t max_failures = 4096)
+	{
+		return runChecked(program(beta_exact), requests, responses, count, upper, failures, status, max_failures);
+	}
+
+	/* Reruns the beta_maxiter entries of failures, from a checked batch of
+	requests, on a build whose continued fraction may run max_iter
+	iterations rather than 512, and writes their new results to responses.
+	Entries that now succeed are removed from failures and the rest take
+	their new status.  Returns the number repaired. */
+	size_t retryChecked(beta_request *requests, beta_response *responses, bool upper, std::vector<beta_failure>& failures, int max_iter = 16384)
+	{
+		std::vector<size_t> retry;
+		for (size_t j = 0; j < failures.size(); j++)
+		{
+			if (failures[j].status == beta_maxiter) {
+				retry.push_back(j);
+			}
+		}
+
+		if (retry.empty()) {
+			return 0;
+		}
+
+		std::unique_ptr<beta_request[]> retry_requests(new beta_request[retry.size()]);
+		std::unique_ptr<beta_response[]> retry_responses(new beta_response[retry.size()]);
+		std::unique_ptr<unsigned char[]> retry_status(new unsigned char[retry.size()]);
+		std::vector<beta_failure> unused;
+
+		for (size_t j = 0; j < retry.size(); j++)
+		{
+			retry_requests[j] = requests[failures[retry[j]].index];
+		}
+
+		beta_status_summary summary = runChecked(retrier(max_iter), retry_requests.get(), retry_responses.get(), retry.size(), upper,
+			unused, retry_status.get(), 0);
+
+		for (size_t j = 0; j < retry.size(); j++)
+		{
+			beta_failure& failure = failures[retry[j]];
+			responses[failure.index].result = retry_responses[j].result;
+			failure.status = retry_status[j];
+		}
+
+		failures.erase(std::remove_if(failures.begin(), failures.end(), [](const beta_failure& failure)
+		{
+			return failure.status == beta_ok;
+		}), failures.end());
+		return summary.by_status[beta_ok];
+	}
+
+	/* Q over x_count points from x_start in steps of x_step, for each of the
+	pair_count (a_values[j], b_values[j]).  Only the description and the
+	parameters go to the device.  results holds x_count * pair_count doubles,
+	x fastest.  tolerance is only read by beta_standard. */
+	void evaluateGridQ(beta_precision precision, double x_start, double x_step, int x_count, const double *a_values, const double *b_values, int pair_count,
+		double *results, double tolerance = 1.0e-8, size_t max_points = (size_t)1 << 24)
+	{
+		evaluateGrid(precision, false, x_start, x_step, x_count, a_values, b_values, pair_count, pair_count, results, tolerance, max_points);
+	}
+
+	/* As evaluateGridQ over every a against every b, a 3D range.  results holds
+	x_count * a_count * b_count doubles, x fastest and b slowest. */
+	void evaluateProductQ(beta_precision precision, double x_start, double x_step, int x_count, const double *a_values, int a_count, const double *b_values, int b_count,
+		double *results, double tolerance = 1.0e-8, size_t max_points = (size_t)1 << 24)
+	{
+		evaluateGrid(precision, true, x_start, x_step, x_count, a_values, b_values, a_count, b_count, results, tolerance, max_points);
+	}
+
+	/* The density, P, Q, ln P and ln Q on the exact tier, one launch and one
+	continued fraction per request. */
+	void fused(beta_request *requests, beta_fused *results, size_t count)
+	{
+		program(beta_exact).RunKernel("gsl_cdf_beta_fused_cl", requests, results, count, 1);
+	}
+
+	/* P, Q, the density and the quantile check on the exact tier for one
+	batch, which is uploaded once and kept on the device for every launch.  P
+	stays there for the check, the x recovered from P less the x asked for,
+	and only the results asked for come back.  Any output may be NULL; P is
+	still computed when only the check wants it.  The batch must fit on the
+	device, see openClDataset. */
+	void profile(beta_request *requests, size_t count, beta_response *P, beta_response *Q, beta_response *pdf, beta_response *check, int max_iter = 64)
+	{
+		if (!count) {
+			return;
+		}
+
+		beta_program& exact = program(beta_exact);
+		openClDataset<beta_request> resident = exact.Upload(requests, count);
+		openClDataset<beta_response> lower = exact.Allocate<beta_response>(P || check ? count : 1);
+		openClDataset<beta_response> scratch = exact.Allocate<beta_response>(Q || pdf || check ? count : 1);
+
+		if (P || check) {
+			exact.RunResident("gsl_cdf_beta_P_cl", count, resident, lower);
+			if (P) {
+				exact.Download(lower, P);
+			}
+		}
+		if (check) {
+			exact.RunResident("gsl_cdf_beta_Pinv_check_cl", count, resident, scratch, lower, max_iter);
+			exact.Download(scratch, check);
+		}
+		if (Q) {
+			exact.RunResident("gsl_cdf_beta_Q_cl", count, resident, scratch);
+			exact.Download(scratch, Q);
+		}
+		if (pdf) {
+			exact.RunResident("gsl_ran_beta_pdf_cl", count, resident, scratch);
+			exact.Download(scratch, pdf);
+		}
+	}
+
+	/* Quantiles on the exact tier, the x with P(x) = p, or Q(x) = p when upper
+	is set.  A request that has not converged after max_iter evaluations gets
+	NaN. */
+	void quantile(beta_quantile_request *requests, beta_response *responses, size_t count, bool upper, int max_iter = 64)
+	{
+		program(beta_exact).RunKernel(upper ? "gsl_cdf_beta_Qinv_cl" : "gsl_cdf_beta_Pinv_cl", requests, responses, count, 1, max_iter);
+	}
+
+	/* Student-t and F probabilities on the exact tier, for t and F statistics
+	from backtests.  Both run through beta_inc_AXPY with the tail taken directly,
+	so small p-values keep their relative accuracy. */
+	void tdist(beta_tail tail, tdist_request *requests, beta_response *responses, size_t count)
+	{
+		static const char *kernels[] = { "gsl_cdf_tdist_P_cl", "gsl_cdf_tdist_Q_cl", "gsl_cdf_tdist_two_sided_cl" };
+		program(beta_exact).RunKernel(kernels[tail], requests, responses, count, 1);
+	}
+
+	void fdist(beta_tail tail, fdist_request *requests, beta_response *responses, size_t count)
+	{
+		static const char *kernels[] = { "gsl_cdf_fdist_P_cl", "gsl_cdf_fdist_Q_cl", "gsl_cdf_fdist_two_sided_cl" };
+		program(beta_exact).RunKernel(kernels[tail], requests, responses, count, 1);
+	}
+
+	/* Binomial and negative binomial P(K <= k), or P(K > k) when upper is set,
+	one incomplete beta per request at any n. */
+	void binomial(binomial_request *requests, beta_response *responses, size_t count, bool upper)
+	{
+		discrete().RunKernel(upper ? "gsl_cdf_binomial_Q_cl" : "gsl_cdf_binomial_P_cl", requests, responses, count, 1);
+	}
+
+	void negative_binomial(binomial_request *requests, beta_response *responses, size_t count, bool upper)
+	{
+		discrete().RunKernel(upper ? "gsl_cdf_negative_binomial_Q_cl" : "gsl_cdf_negative_binomial_P_cl", requests, responses, count, 1);
+	}
+
+	/* Beta-binomial P(K <= k), or P(K > k) when upper is set.  Each request
+	sums the tail on the far side of k from the mean, stopping early when alpha
+	and beta are at least 1, so sort a large batch by n if it varies widely. */
+	void beta_binomial(beta_binomial_request *requests, beta_response *responses, size_t count, bool upper)
+	{
+		discrete().RunKernel(upper ? "gsl_cdf_beta_binomial_Q_cl" : "gsl_cdf_beta_binomial_P_cl", requests, responses, count, 1);
+	}
+
+	/* Runs sweeps on the exact tier.  Offsets must already be laid out in
+	results, which holds total doubles.  responses[i].result is the number of
+	anchors sweep i needed. */
+	void sweep(beta_sweep_request *requests, beta_response *responses, size_t count, double *results, size_t total, double tolerance)
+	{
+		program(beta_exact).RunKernel("gsl_cdf_beta_sweep_cl", requests, responses, count, 1, openClOut(results, total), tolerance);
+	}
+
+	/* Q on the exact tier for a batch, reduced on the device to a single
+	beta_aggregate: the sum of Q, the sum of weights[i] * Q (weights may be
+	NULL for all ones), the smallest and largest Q with their indices, and
+	how many Q are over threshold.  The responses never leave the device:
+	one 56 byte partial per work group comes back and is folded on the host,
+	a few groups a compute unit at any batch size, so a few kilobytes against
+	160 MB of responses for ten million requests.  Nothing goes up but the
+	requests and the weights. */
+	beta_aggregate reduceQ(beta_request *requests, size_t count, const double *weights = NULL, double threshold = 1.0)
+	{
+		double unit = 1.0;
+		int weighted = weights != NULL;
+
+		return reducer().RunReduce("gsl_cdf_beta_Q_reduce_cl", requests, count, beta_aggregate_identity(), beta_aggregate_combine,
+			openClIn(weighted ? weights : &unit, weighted ? count : 1), weighted, threshold);
+	}
+
+	/* Q on the exact tier for a batch, keeping only the results over
+	threshold: thresholds[i] for each request, or threshold for all when
+	thresholds is NULL.  Hits are compacted on the device and only they come
+	back, appended to hits in request order.  Batches go to the device
+	max_batch requests at a time, so the batch itself need not fit there.
+	Returns the number of hits. */
+	size_t filterQ(beta_request *requests, size_t count, std::vector<beta_hit>& hits, const double *thresholds, double threshold = 0.99, size_t max_batch = (size_t)1 << 22)
+	{
+		size_t first_hit = hits.size();
+		int per_request = thresholds != NULL;
+
+		for (size_t first = 0; first < count; first += max_batch)
+		{
+			size_t n = std::min(max_batch, count - first);
+			size_t chunk_hit = hits.size();
+
+			reducer().RunCompact("gsl_cdf_beta_Q_filter_cl", requests + first, n, hits,
+				openClIn(per_request ? thresholds + first : &threshold, per_request ? n : 1), per_request);
+
+			for (size_t j = chunk_hit; j < hits.size(); j++)
+			{
+				hits[j].index += first;
+			}
+		}
+
+		std::sort(hits.begin() + first_hit, hits.end(), [](const beta_hit& left, const beta_hit& right)
+		{
+			return left.index < right.index;
+		});
+		return hits.size() - first_hit;
+	}
+
+	/* Two pass Q.  Every request goes through incBetaQEstimate, which returns an
+	error estimate with its result; only those whose estimate is over tolerance
+	(or not finite) are packed into a second batch for the exact tier.  Returns
+	the number of requests refined. */
+	size_t evaluateQRefined(beta_request *requests, beta_response *responses, size_t count, double tolerance)
+	{
+		std::unique_ptr<beta_estimate[]> estimates(new beta_estimate[count]);
+
+		// the estimate charges about 2x the last Lentz step per geometric tail, so stop well under tolerance
+		double stop = std::max(tolerance / 40.0, 1.0e-15);
+		program(beta_standard).RunKernel("incBetaQEstimate", requests, estimates.get(), count, 1, stop);
+
+		std::vector<size_t> refine;
+		for (size_t i = 0; i < count; i++)
+		{
+			responses[i].threadid = estimates[i].threadid;
+			responses[i].result = estimates[i].result;
+			if (!(estimates[i].err <= tolerance)) {
+				refine.push_back(i);
+			}
+		}
+
+		if (refine.empty()) {
+			return 0;
+		}
+
+		std::unique_ptr<beta_request[]> refine_requests(new beta_request[refine.size()]);
+		std::unique_ptr<beta_response[]> refine_responses(new beta_response[refine.size()]);
+
+		for (size_t j = 0; j < refine.size(); j++)
+		{
+			refine_requests[j] = requests[refine[j]];
+		}
+
+		evaluateQ(beta_exact, refine_requests.get(), refine_responses.get(), refine.size());
+
+		for (size_t j = 0; j < refine.size(); j++)
+		{
+			responses[refine[j]].result = refine_responses[j].result;
+		}
+
+		return refine.size();
+	}
+};
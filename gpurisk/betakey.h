@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string.h>
+
+/* beta_key identifies a beta_request by the exact bit patterns of x, a and b,
+so two requests only match when they would produce bit-identical results. */
+
+struct beta_key
+{
+	unsigned __int64 x, a, b;
+
+	static beta_key from(const beta_request& request)
+	{
+		beta_key key;
+		memcpy(&key.x, &request.x, sizeof(key.x));
+		memcpy(&key.a, &request.a, sizeof(key.a));
+		memcpy(&key.b, &request.b, sizeof(key.b));
+		return key;
+	}
+
+	bool operator == (const beta_key& _src) const
+	{
+		return x == _src.x && a == _src.a && b == _src.b;
+	}
+
+	bool operator != (const beta_key& _src) const
+	{
+		return !(*this == _src);
+	}
+
+	bool operator < (const beta_key& _src) const
+	{
+		if (x != _src.x) return x < _src.x;
+		if (a != _src.a) return a < _src.a;
+		return b < _src.b;
+	}
+
+	// murmur3 64 bit finalizer, a bijection on 64 bit words
+	static unsigned __int64 mix(unsigned __int64 h)
+	{
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDULL;
+		h ^= h >> 33;
+		h *= 0xC4CEB9FE1A85EC53ULL;
+		h ^= h >> 33;
+		return h;
+	}
+
+	/* Bumped whenever hash() changes.  Persisted caches (betacache.h) record
+	it, since entries placed by one hash are never probed by another. */
+	static const unsigned int hash_version = 2;
+
+	// chained so that for fixed a and b distinct x always give distinct hashes
+	unsigned __int64 hash() const
+	{
+		return mix(x ^ mix(a ^ mix(b ^ 0x9E3779B97F4A7C15ULL)));
+	}
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <ppl.h>
+
+#include "betakey.h"
+
+/* Host copies of the parameter table structs in nativebeta.cl and gslbeta.cl
+(gsl_cdf_beta_param and gsl_cdf_beta_param_request have the same layout). */
+
+struct beta_param
+{
+	double a, b, lnbeta;
+};
+
+typedef struct beta_param beta_param;
+
+struct beta_param_request
+{
+	double x;
+	int param;
+};
+
+typedef struct beta_param_request beta_param_request;
+
+/* beta_param_table gives every distinct (a, b) seen in a session an id and
+holds ln(B(a,b)) for it, so a kernel reads one value from global memory
+instead of evaluating three log gammas per request.  Portfolios draw from a
+few thousand parameter pairs, so the table is small and, once warm, a new
+batch only pays for the pairs it has not seen before.
+
+The table does not compute ln(B) itself; the caller hands compute() the
+function to use, usually gsl::gsl_sf_lnbeta, which serves integer and half
+integer arguments straight from fact_table. */
+
+class beta_param_table
+{
+	struct pair_key
+	{
+		unsigned __int64 a, b;
+
+		bool operator == (const pair_key& _src) const
+		{
+			return a == _src.a && b == _src.b;
+		}
+	};
+
+	struct pair_hash
+	{
+		size_t operator()(const pair_key& key) const
+		{
+			return (size_t)beta_key::mix(key.a ^ beta_key::mix(key.b));
+		}
+	};
+
+	std::vector<beta_param> params;
+	std::unordered_map<pair_key, int, pair_hash> ids;
+	size_t computed;
+
+	// consecutive requests usually share parameters, so the last id short circuits the map
+	pair_key last_key;
+	int last_id;
+
+public:
+
+	beta_param_table() : computed(0), last_id(-1)
+	{
+		;
+	}
+
+	// the id of (a, b), adding it to the table when it is new
+	int id_of(double a, double b)
+	{
+		pair_key key;
+		memcpy(&key.a, &a, sizeof(key.a));
+		memcpy(&key.b, &b, sizeof(key.b));
+
+		if (last_id >= 0 && key == last_key) {
+			return last_id;
+		}
+
+		auto found = ids.find(key);
+		if (found == ids.end()) {
+			beta_param param = { a, b, 0.0 };
+			found = ids.emplace(key, (int)params.size()).first;
+			params.push_back(param);
+		}
+
+		last_key = key;
+		last_id = found->second;
+		return last_id;
+	}
+
+	/* Rewrites a batch of requests against the table.  New pairs are added
+	but their ln(B) is not filled in until compute() runs. */
+	void build(const beta_request *requests, beta_param_request *param_requests, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			param_requests[i].x = requests[i].x;
+			param_requests[i].param = id_of(requests[i].a, requests[i].b);
+		}
+	}
+
+	// fills in ln(B) for every pair added since the last call, lnbeta(a, b) must be thread safe
+	template <class LnBeta> void compute(LnBeta lnbeta)
+	{
+		concurrency::parallel_for(computed, params.size(), [&](size_t i)
+		{
+			params[i].lnbeta = lnbeta(params[i].a, params[i].b);
+		});
+		computed = params.size();
+	}
+
+	const beta_param *data() const
+	{
+		return params.data();
+	}
+
+	size_t size() const
+	{
+		return params.size();
+	}
+
+	void clear()
+	{
+		params.clear();
+		ids.clear();
+		computed = 0;
+		last_id = -1;
+	}
+};
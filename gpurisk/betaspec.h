@@ -0,0 +1,301 @@
+#pragma once
+
+#include <memory>
+#include <map>
+#include <list>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+
+#include "openclhost.h"
+#include "file_data.h"
+#include "gslsource.h"
+
+/* beta_specializer runs gsl_cdf_beta_spec_cl in gslspec.cl, a batch of x
+for one (a, b), and compiles a variant of it for each pair that is asked
+for often, with a, b and ln(B(a,b)) built in as literals.  Until a pair has
+been asked for threshold times its batches go to the generic build, so a
+pair seen once never pays for a compile.
+
+Variants are kept in least recently used order; past capacity the oldest
+is released.  Every variant is built on the generic build's device and
+context, so a hundred variants still hold one context between them.  When a
+binary prefix is given each variant's compiled binary is also saved as
+prefix + the bits of a, b and ln_beta + ".bin", and a later
+session, or a variant evicted and needed again, loads it instead of
+compiling.  The binary follows a binary_header holding a hash of what it
+was built from: the spliced gslbeta.cl and gslspec.cl text, the build
+options, and the device's CL_DEVICE_NAME and CL_DRIVER_VERSION.  A binary
+whose hash does not match, after an edit to gslcore.h, another device or a
+driver update, or one the device rejects, is rebuilt from source and saved
+over.
+
+ln(B(a,b)) comes from the caller, usually gsl::gsl_sf_lnbeta, which is both
+what the generic build is passed and what a variant is built with.  A
+variant is keyed on all three, so a caller passing another ln_beta for the
+same pair gets a variant built with that one. */
+
+class beta_specializer
+{
+	typedef openClProgram<double, double> spec_program;
+
+	struct pair_key
+	{
+		unsigned __int64 a, b, ln_beta;
+
+		bool operator < (const pair_key& _src) const
+		{
+			if (a != _src.a) {
+				return a < _src.a;
+			}
+			return b != _src.b ? b < _src.b : ln_beta < _src.ln_beta;
+		}
+	};
+
+	struct variant
+	{
+		std::unique_ptr<spec_program> program;
+		std::list<pair_key>::iterator age;
+	};
+
+	struct binary_header
+	{
+		char magic[8];
+		unsigned __int64 build_hash;
+	};
+
+	int gpu_type;
+	unsigned int threshold;
+	size_t capacity;
+	std::string binary_prefix;
+
+	std::unique_ptr<spec_program> generic_cl;
+	std::map<pair_key, unsigned int> uses;
+	std::map<pair_key, variant> variants;
+	std::list<pair_key> ages;			// most recently used first
+
+	size_t compiled, loaded, evicted;
+
+	// counts for pairs that never got hot are dropped past this many pairs
+	static const size_t max_tracked = 65536;
+
+	static pair_key key_of(double a, double b, double ln_beta)
+	{
+		pair_key key;
+		memcpy(&key.a, &a, sizeof(key.a));
+		memcpy(&key.b, &b, sizeof(key.b));
+		memcpy(&key.ln_beta, &ln_beta, sizeof(key.ln_beta));
+		return key;
+	}
+
+	std::string binary_name(const pair_key& key) const
+	{
+		char name[80];
+		sprintf(name, "%016llx_%016llx_%016llx.bin", (unsigned long long)key.a, (unsigned long long)key.b, (unsigned long long)key.ln_beta);
+		return binary_prefix + name;
+	}
+
+	// FNV-1a over text and its terminating zero, so consecutive texts cannot run together
+	static unsigned __int64 hash_text(unsigned __int64 h, const char *text)
+	{
+		do {
+			h ^= (unsigned char)*text;
+			h *= 0x100000001B3ULL;
+		} while (*text++);
+		return h;
+	}
+
+	// the hash a saved binary built with build_options is keyed on
+	unsigned __int64 build_hash(const char *build_options) const
+	{
+		gsl_source gsl;
+		io::file_data spec("gslspec.cl");
+		std::string device_name = spec_program::GetDeviceString(CL_DEVICE_NAME, gpu_type);
+		std::string driver_version = spec_program::GetDeviceString(CL_DRIVER_VERSION, gpu_type);
+
+		unsigned __int64 h = 0xCBF29CE484222325ULL;
+		h = hash_text(h, gsl.get_data());
+		h = hash_text(h, spec.get_data());
+		h = hash_text(h, build_options);
+		h = hash_text(h, device_name.c_str());
+		h = hash_text(h, driver_version.c_str());
+		return h;
+	}
+
+	spec_program& generic()
+	{
+		if (!generic_cl) {
+			gsl_source gsl;
+			io::file_data spec("gslspec.cl");
+			const char *sources[2] = { gsl.get_data(), spec.get_data() };
+			generic_cl.reset(new spec_program(sources, 2, gpu_type));
+		}
+		return *generic_cl;
+	}
+
+	// a variant built from source on the generic build's context
+	std::unique_ptr<spec_program> build(const char *build_options)
+	{
+		spec_program& share = generic();
+		gsl_source gsl;
+		io::file_data spec("gslspec.cl");
+		const char *sources[2] = { gsl.get_data(), spec.get_data() };
+		return std::unique_ptr<spec_program>(new spec_program(share, sources, 2, build_options));
+	}
+
+	std::unique_ptr<spec_program> load_binary(const std::string& file_name, unsigned __int64 hash)
+	{
+		spec_program& share = generic();
+		FILE *fp = fopen(file_name.c_str(), "rb");
+		if (!fp) {
+			return nullptr;
+		}
+
+		std::vector<unsigned char> binary;
+		unsigned char buffer[65536];
+		size_t read;
+		while ((read = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+			binary.insert(binary.end(), buffer, buffer + read);
+		}
+		fclose(fp);
+
+		binary_header header;
+		if (binary.size() <= sizeof(header)) {
+			return nullptr;
+		}
+
+		memcpy(&header, binary.data(), sizeof(header));
+		if (memcmp(header.magic, "BETASPEC", sizeof(header.magic)) != 0 || header.build_hash != hash) {
+			return nullptr;
+		}
+
+		try
+		{
+			return std::unique_ptr<spec_program>(new spec_program(share, binary.data() + sizeof(header), binary.size() - sizeof(header)));
+		}
+		catch (std::exception&)
+		{
+			return nullptr;
+		}
+	}
+
+	// a failed save only costs the next session a compile
+	void save_binary(spec_program& program, const std::string& file_name, unsigned __int64 hash)
+	{
+		std::vector<unsigned char> binary = program.GetBinary();
+		binary_header header;
+		memcpy(header.magic, "BETASPEC", sizeof(header.magic));
+		header.build_hash = hash;
+
+		FILE *fp = fopen(file_name.c_str(), "wb");
+		if (fp) {
+			bool written = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+				fwrite(binary.data(), 1, binary.size(), fp) == binary.size();
+			fclose(fp);
+			if (!written) {
+				remove(file_name.c_str());
+			}
+		}
+	}
+
+	std::unique_ptr<spec_program> specialize(const pair_key& key, double a, double b, double ln_beta)
+	{
+		// %.17g round trips, so the literals are the same doubles the generic build is passed
+		char options[256];
+		sprintf(options, "-DBETA_SPEC_A=%.17g -DBETA_SPEC_B=%.17g -DBETA_SPEC_LNBETA=%.17g", a, b, ln_beta);
+
+		std::string file_name;
+		unsigned __int64 hash = 0;
+		if (!binary_prefix.empty()) {
+			file_name = binary_name(key);
+			hash = build_hash(options);
+			std::unique_ptr<spec_program> program = load_binary(file_name, hash);
+			if (program) {
+				loaded++;
+				return program;
+			}
+		}
+
+		std::unique_ptr<spec_program> program = build(options);
+		compiled++;
+
+		if (!file_name.empty()) {
+			save_binary(*program, file_name, hash);
+		}
+		return program;
+	}
+
+	// the variant for key, made most recent, or null while the pair is not hot
+	spec_program *variant_of(const pair_key& key, double a, double b, double ln_beta)
+	{
+		auto found = variants.find(key);
+		if (found != variants.end()) {
+			ages.splice(ages.begin(), ages, found->second.age);
+			return found->second.program.get();
+		}
+
+		if (uses.size() >= max_tracked && !uses.count(key)) {
+			uses.clear();
+		}
+		if (++uses[key] < threshold) {
+			return nullptr;
+		}
+
+		std::unique_ptr<spec_program> program = specialize(key, a, b, ln_beta);
+		uses.erase(key);
+
+		if (variants.size() >= capacity) {
+			variants.erase(ages.back());
+			ages.pop_back();
+			evicted++;
+		}
+
+		ages.push_front(key);
+		variant& entry = variants[key];
+		entry.program = std::move(program);
+		entry.age = ages.begin();
+		return entry.program.get();
+	}
+
+public:
+
+	/* threshold is how many batches a pair is asked for before it gets a
+	variant, capacity how many variants are kept.  An empty binary_prefix
+	keeps no binaries. */
+	beta_specializer(unsigned int _threshold = 4, size_t _capacity = 16, const char *_binary_prefix = "", int _gpu_type = CL_DEVICE_TYPE_GPU) :
+		gpu_type(_gpu_type),
+		threshold(_threshold ? _threshold : 1),
+		capacity(_capacity ? _capacity : 1),
+		binary_prefix(_binary_prefix),
+		compiled(0),
+		loaded(0),
+		evicted(0)
+	{
+		;
+	}
+
+	// builds the generic program ahead of the first batch so the build is not timed with it
+	void prepare()
+	{
+		generic();
+	}
+
+	/* P, or Q when upper is set, of count x for one (a, b) with
+	ln_beta = ln(B(a,b)).  Returns true when a specialized variant ran. */
+	bool evaluate(double a, double b, double ln_beta, double *x, double *values, size_t count, bool upper)
+	{
+		if (!count) {
+			return false;
+		}
+
+		spec_program *program = variant_of(key_of(a, b, ln_beta), a, b, ln_beta);
+		(program ? *program : generic()).RunKernel("gsl_cdf_beta_spec_cl", x, values, count, 1, a, b, ln_beta, (int)upper);
+		return program != nullptr;
+	}
+
+	size_t variant_count() const { return variants.size(); }
+	size_t compiled_count() const { return compiled; }
+	size_t loaded_count() const { return loaded; }
+	size_t evicted_count() const { return evicted; }
+};
@@ -0,0 +1,58 @@
+/*
+ * Queries against a piecewise Chebyshev table of I_x(a, b) built by
+ * beta_chebyshev in betacheb.h.  A query finds its piece by bisection on lo
+ * and sums the piece with Clenshaw's recurrence, a fixed 16 term loop, so
+ * work items only diverge on the piece search and the optional power factor.
+ */
+
+#define BETA_CHEB_TERMS 16
+
+struct beta_cheb_piece
+{
+	double lo, hi;
+	double power;
+	int upper;
+	int reserved;
+	double c[BETA_CHEB_TERMS];
+};
+
+typedef struct beta_cheb_piece beta_cheb_piece;
+
+double cheb_piece_value(__global const beta_cheb_piece *piece, double x)
+{
+	double t = (2.0 * x - piece->lo - piece->hi) / (piece->hi - piece->lo);
+	double b1 = 0.0, b2 = 0.0;
+
+	for (int k = BETA_CHEB_TERMS - 1; k >= 1; k--) {
+		double b0 = piece->c[k] + 2.0 * t * b1 - b2;
+		b2 = b1;
+		b1 = b0;
+	}
+
+	double v = piece->c[0] + t * b1 - b2;
+	if (piece->power != 0.0) {
+		v *= pow(piece->upper ? 1.0 - x : x, piece->power);
+	}
+	return v;
+}
+
+/* P of each x, or Q when upper is set */
+__kernel void incBetaCheb(__global const double *x, __global double *value, __global const beta_cheb_piece *pieces, const int piece_count, const int upper)
+{
+	int threadId = get_global_id(0);
+	double xi = x[threadId];
+
+	if (xi <= 0.0 || xi >= 1.0) {
+		value[threadId] = (xi <= 0.0) == (upper != 0) ? 1.0 : 0.0;
+		return;
+	}
+
+	int lo = 0, hi = piece_count - 1;
+	while (lo < hi) {
+		int mid = (lo + hi + 1) / 2;
+		if (pieces[mid].lo <= xi) lo = mid; else hi = mid - 1;
+	}
+
+	double v = cheb_piece_value(&pieces[lo], xi);
+	value[threadId] = pieces[lo].upper == upper ? v : 1.0 - v;
+}
@@ -96,9 +96,9 @@ namespace io
 				if (fp != nullptr) 
 				{
 					char *buffer = new char[length + 1];
-					fread(buffer, 1, length, fp);
+					size_t read = fread(buffer, 1, length, fp);
 					fclose(fp);
-					buffer[length] = 0;
+					buffer[read] = 0;
 					converted_str = buffer;
 					delete[] buffer;
 				}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "openclhost.h"
+#include "file_data.h"
+#include "gslsource.h"
+
+/* Host copies of the request structs in gslgamma.cl.  Responses are
+beta_response, as for the beta kernels. */
+
+// b is the scale, so the mean is a b
+struct gamma_request
+{
+	double x, a, b;
+};
+
+typedef struct gamma_request gamma_request;
+
+struct chisq_request
+{
+	double x, nu;
+};
+
+typedef struct chisq_request chisq_request;
+
+enum gamma_tail
+{
+	gamma_lower,
+	gamma_upper
+};
+
+/* The branches of gsl_sf_gamma_inc_P_e and gsl_sf_gamma_inc_Q_e, which is
+where gsl_cdf_gamma_P and Q send a request with y = x / b.  The tests here
+must follow the ones in gslport.h; a request put in the wrong regime is still
+answered correctly, it only shares a wavefront with the wrong neighbours. */
+enum gamma_regime
+{
+	gamma_series,
+	gamma_continued_fraction,
+	gamma_large_x,
+	gamma_asymptotic,
+	gamma_regime_count
+};
+
+inline gamma_regime gamma_regime_of(double a, double y)
+{
+	if (y > a) {
+		// gsl_sf_gamma_inc_Q_e
+		if (a >= 1.0e6 && (y - a) * (y - a) < a) {
+			return gamma_asymptotic;
+		}
+		if (a < 0.2 && y < 5.0) {
+			return gamma_series;
+		}
+		return y <= 1.0e6 ? gamma_continued_fraction : gamma_large_x;
+	}
+
+	// gsl_sf_gamma_inc_P_e
+	if (y < 20.0 || y < 0.5 * a) {
+		return gamma_series;
+	}
+	if (a > 1.0e6 && (y - a) * (y - a) < a) {
+		return gamma_asymptotic;
+	}
+	return (y - a) * (y - a) < a ? gamma_continued_fraction : gamma_series;
+}
+
+/* gamma_engine runs gamma and chi-square batches on gslbeta.cl and
+gslgamma.cl.  A batch is put in regime order with a counting sort, sent as
+one launch, and the responses are scattered back to request order, so a
+caller sees the same batch it would get from an unsorted launch.  A series
+request next to a continued fraction one costs the wavefront both. */
+class gamma_engine
+{
+	typedef openClProgram<gamma_request, beta_response> gamma_program;
+
+	int gpu_type;
+	std::unique_ptr<gamma_program> gamma_cl;
+	std::vector<size_t> order;
+	std::vector<unsigned char> regimes;
+	size_t counts[gamma_regime_count];
+
+	gamma_program& program()
+	{
+		if (!gamma_cl) {
+			gsl_source gsl;
+			io::file_data gamma("gslgamma.cl");
+			const char *sources[2] = { gsl.get_data(), gamma.get_data() };
+			gamma_cl.reset(new gamma_program(sources, 2, gpu_type));
+		}
+		return *gamma_cl;
+	}
+
+	static void shape_of(const gamma_request& request, double& a, double& y)
+	{
+		a = request.a;
+		y = request.x / request.b;
+	}
+
+	static void shape_of(const chisq_request& request, double& a, double& y)
+	{
+		a = request.nu / 2.0;
+		y = request.x / 2.0;
+	}
+
+	// fills order with the request indices, regime by regime
+	template <class Request> void partition(const Request *requests, size_t count)
+	{
+		size_t offsets[gamma_regime_count] = {};
+
+		regimes.resize(count);
+		order.resize(count);
+		std::fill(counts, counts + gamma_regime_count, 0);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			double a, y;
+			shape_of(requests[i], a, y);
+			regimes[i] = (unsigned char)gamma_regime_of(a, y);
+			counts[regimes[i]]++;
+		}
+
+		for (int r = 1; r < gamma_regime_count; r++)
+		{
+			offsets[r] = offsets[r - 1] + counts[r - 1];
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			order[offsets[regimes[i]]++] = i;
+		}
+	}
+
+	template <class Request> void run(const char *kernel, const Request *requests, beta_response *responses, size_t count)
+	{
+		if (!count) {
+			return;
+		}
+
+		partition(requests, count);
+
+		std::unique_ptr<Request[]> sorted(new Request[count]);
+		std::unique_ptr<beta_response[]> sorted_responses(new beta_response[count]);
+
+		for (size_t j = 0; j < count; j++)
+		{
+			sorted[j] = requests[order[j]];
+		}
+
+		program().RunKernel(kernel, sorted.get(), sorted_responses.get(), count, 1);
+
+		for (size_t j = 0; j < count; j++)
+		{
+			responses[order[j]].threadid = (int)order[j];
+			responses[order[j]].result = sorted_responses[j].result;
+		}
+	}
+
+public:
+
+	gamma_engine(int _gpu_type = CL_DEVICE_TYPE_GPU) : gpu_type(_gpu_type)
+	{
+		std::fill(counts, counts + gamma_regime_count, 0);
+	}
+
+	// builds the program ahead of the first batch so the build is not timed with it
+	void prepare()
+	{
+		program();
+	}
+
+	// P or Q of the gamma distribution with shape a and scale b
+	void evaluate(gamma_tail tail, const gamma_request *requests, beta_response *responses, size_t count)
+	{
+		run(tail == gamma_lower ? "gsl_cdf_gamma_P_cl" : "gsl_cdf_gamma_Q_cl", requests, responses, count);
+	}
+
+	// P or Q of the chi-square distribution with nu degrees of freedom
+	void evaluate(gamma_tail tail, const chisq_request *requests, beta_response *responses, size_t count)
+	{
+		run(tail == gamma_lower ? "gsl_cdf_chisq_P_cl" : "gsl_cdf_chisq_Q_cl", requests, responses, count);
+	}
+
+	// how many requests of the last batch fell in each regime
+	size_t regime_count(gamma_regime regime) const
+	{
+		return counts[regime];
+	}
+};
@@ -78,8 +78,8 @@ __kernel void test_numbers(__global testInputStruct* input, __global testOutputS
 
 void riskOpenClTest()
 {
-	io::file_data fdGsl("gslbeta.cl"),
-				  fdNative("nativebeta.cl");
+	gsl_source fdGsl;
+	io::file_data fdNative("nativebeta.cl");
 
 	const int num_requests = 10000000;
 	const int group_size = num_requests / 10;
@@ -229,12 +229,1269 @@ void riskOpenClTest()
 	}
 }
 
+void riskCacheTest()
+{
+	io::file_data fdNative("nativebeta.cl");
+
+	const int num_requests = 1000000;
+	const int group_size = num_requests / 10;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].a = 1 + i / group_size;
+		requests[i].b = 2;
+		requests[i].x = (double)(i % group_size) / (double)group_size;
+	}
+
+	openClProgram<beta_request, beta_response> programGpu(fdNative.get_data(), CL_DEVICE_TYPE_GPU);
+
+	beta_cache cache(num_requests * 2, "betaq.cache", "nativebeta.cl incBetaQ");
+
+	auto engine = [&](beta_request *misses, beta_response *results, size_t count) {
+		programGpu.RunKernel("incBetaQ", misses, results, count, 1);
+	};
+
+	for (int pass = 0; pass < 3; pass++)
+	{
+		// shift one group each pass, as an intraday rerun with a few changed parameters would
+		for (int i = 0; i < group_size; i++)
+		{
+			requests[i].b = 2 + pass;
+		}
+
+		sys::benchmarker bmCache;
+		cache.reset_counters();
+
+		bmCache.start();
+		cache.evaluate(requests.get(), responses.get(), num_requests, engine);
+		bmCache.stop();
+
+		std::cout << "Pass " << pass << " ran " << num_requests << " beta Q's in " << bmCache.getTotalSeconds() << " seconds, "
+			<< cache.hits() << " hits " << cache.misses() << " misses " << cache.evictions() << " evictions" << std::endl;
+	}
+
+	cache.flush();
+}
+
+void riskDedupTest()
+{
+	io::file_data fdNative("nativebeta.cl");
+
+	// ten scenarios that share most of their grid, as intraday reruns do
+	const int grid_size = 100000;
+	const int num_scenarios = 10;
+	const int num_requests = grid_size * num_scenarios;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		int scenario = i / grid_size;
+		int point = i % grid_size;
+		requests[i].a = 2 + (point % 10);
+		requests[i].b = point < grid_size / 10 ? 2 + scenario : 5;
+		requests[i].x = (double)(point / 10) / (double)(grid_size / 10);
+	}
+
+	openClProgram<beta_request, beta_response> programGpu(fdNative.get_data(), CL_DEVICE_TYPE_GPU);
+
+	beta_dedup dedup;
+
+	sys::benchmarker bmDedup;
+	bmDedup.start();
+	dedup.evaluate(requests.get(), responses.get(), num_requests, [&](beta_request *unique, beta_response *results, size_t count) {
+		programGpu.RunKernel("incBetaQ", unique, results, count, 1);
+	});
+	bmDedup.stop();
+
+	std::cout << "Ran " << num_requests << " beta Q's as " << dedup.last().unique << " unique in " << bmDedup.getTotalSeconds() << " seconds, sampled duplicate ratio "
+		<< dedup.last().sampled_ratio << (dedup.last().bypassed ? " (bypassed)" : "") << std::endl;
+}
+
+void riskLnbetaTableTest()
+{
+	gsl_source fdGsl;
+
+	// a portfolio drawn from a few thousand distinct (a, b)
+	const int num_requests = 1000000;
+	const int num_params = 2000;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_param_request[]> param_requests(new beta_param_request[num_requests]);
+	std::unique_ptr<beta_response[]>
+		responses_gpu(new beta_response[num_requests]),
+		responses_cpu(new beta_response[num_requests]),
+		responses_stock(new beta_response[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		int param = i % num_params;
+		requests[i].a = 0.5 * (1 + param % 40);
+		requests[i].b = 0.25 + param / 40;
+		requests[i].x = (double)(i / num_params) / (double)(num_requests / num_params);
+	}
+
+	beta_param_table table;
+
+	sys::benchmarker bmTable;
+	bmTable.start();
+	table.build(requests.get(), param_requests.get(), num_requests);
+	table.compute([](double a, double b) { return gsl::gsl_sf_lnbeta(a, b); });
+	bmTable.stop();
+
+	std::cout << "Built " << table.size() << " lnbeta entries in " << bmTable.getTotalSeconds() << " seconds" << std::endl;
+
+	{
+		sys::benchmarker bmStock;
+		bmStock.start();
+		concurrency::parallel_for(0, num_requests, [&](int i)
+		{
+			responses_stock[i].result = gsl::gsl_cdf_beta_Q(requests[i].x, requests[i].a, requests[i].b);
+		});
+		bmStock.stop();
+
+		std::cout << "Ran stock " << num_requests << " beta Q's in " << bmStock.getTotalSeconds() << " seconds" << std::endl;
+	}
+
+	{
+		sys::benchmarker bmCPU;
+		bmCPU.start();
+		concurrency::parallel_for(0, num_requests, [&](int i)
+		{
+			const beta_param& param = table.data()[param_requests[i].param];
+			responses_cpu[i].result = gsl::gsl_cdf_beta_Q_lnbeta(param_requests[i].x, param.a, param.b, param.lnbeta);
+		});
+		bmCPU.stop();
+
+		std::cout << "Ran table " << num_requests << " beta Q's in " << bmCPU.getTotalSeconds() << " seconds" << std::endl;
+	}
+
+	{
+		sys::benchmarker bmGPU;
+		openClProgram<beta_param_request, beta_response> programGpu(fdGsl.get_data(), CL_DEVICE_TYPE_GPU);
+
+		bmGPU.start();
+		programGpu.RunKernel("gsl_cdf_beta_Q_param_cl", param_requests.get(), responses_gpu.get(), num_requests, 1, openClIn(table.data(), table.size()));
+		bmGPU.stop();
+
+		std::cout << "Ran GPU table " << num_requests << " beta Q's in " << bmGPU.getTotalSeconds() << " seconds" << std::endl;
+	}
+
+	double max_cpu = 0.0, max_gpu = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		max_cpu = std::max(max_cpu, fabs(responses_cpu[i].result - responses_stock[i].result));
+		max_gpu = std::max(max_gpu, fabs(responses_gpu[i].result - responses_stock[i].result));
+	}
+
+	std::cout << "Largest difference from stock, table " << max_cpu << " GPU table " << max_gpu << std::endl;
+}
+
+void riskPrecisionTest()
+{
+	const double ab[] = { 0.01, 0.1, 0.5, 1, 2, 5, 10, 100, 1000 };
+	const int num_ab = sizeof(ab) / sizeof(ab[0]);
+	const int num_x = 1000;
+	const int num_requests = num_ab * num_ab * (num_x + 1);
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_requests]);
+	std::unique_ptr<double[]> stock(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].a = ab[i / (num_ab * (num_x + 1))];
+		requests[i].b = ab[(i / (num_x + 1)) % num_ab];
+		requests[i].x = (double)(i % (num_x + 1)) / (double)num_x;
+		stock[i] = gsl::gsl_cdf_beta_Q(requests[i].x, requests[i].a, requests[i].b);
+	}
+
+	beta_tiers tiers;
+
+	struct tier_run
+	{
+		const char *name;
+		beta_precision precision;
+		double tolerance;
+	} runs[] = {
+		{ "fast", beta_fast, 0.0 },
+		{ "standard 1e-6", beta_standard, 1.0e-6 },
+		{ "standard 1e-10", beta_standard, 1.0e-10 },
+		{ "exact", beta_exact, 0.0 }
+	};
+
+	for (auto& run : runs)
+	{
+		tiers.prepare(run.precision);
+
+		sys::benchmarker bmTier;
+		bmTier.start();
+		tiers.evaluateQ(run.precision, requests.get(), responses.get(), num_requests, run.tolerance);
+		bmTier.stop();
+
+		double max_error = 0.0;
+		for (int i = 0; i < num_requests; i++)
+		{
+			max_error = std::max(max_error, fabs(responses[i].result - stock[i]));
+		}
+
+		double bound = beta_precision_bound(run.precision, run.tolerance);
+		std::cout << std::setw(15) << run.name << " ran " << num_requests << " beta Q's in " << bmTier.getTotalSeconds() << " seconds, max error "
+			<< max_error << (max_error <= bound ? " within " : " EXCEEDS ") << bound << std::endl;
+	}
+}
+
+void riskRefineTest()
+{
+	const double ab[] = { 0.01, 0.1, 0.5, 1, 2, 5, 10, 100, 1000, 3000 };
+	const int num_ab = sizeof(ab) / sizeof(ab[0]);
+	const int num_x = 1000;
+	const int num_requests = num_ab * num_ab * (num_x + 1);
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_requests]);
+	std::unique_ptr<double[]> stock(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].a = ab[i / (num_ab * (num_x + 1))];
+		requests[i].b = ab[(i / (num_x + 1)) % num_ab];
+		requests[i].x = (double)(i % (num_x + 1)) / (double)num_x;
+		stock[i] = gsl::gsl_cdf_beta_Q(requests[i].x, requests[i].a, requests[i].b);
+	}
+
+	beta_tiers tiers;
+	tiers.prepare(beta_standard);
+	tiers.prepare(beta_exact);
+
+	const double tolerances[] = { 1.0e-6, 1.0e-10, 1.0e-12 };
+
+	for (double tolerance : tolerances)
+	{
+		sys::benchmarker bmRefine;
+		bmRefine.start();
+		size_t refined = tiers.evaluateQRefined(requests.get(), responses.get(), num_requests, tolerance);
+		bmRefine.stop();
+
+		double max_error = 0.0;
+		for (int i = 0; i < num_requests; i++)
+		{
+			max_error = std::max(max_error, fabs(responses[i].result - stock[i]));
+		}
+
+		std::cout << "Tolerance " << tolerance << " ran " << num_requests << " beta Q's in " << bmRefine.getTotalSeconds() << " seconds, "
+			<< refined << " refined, max error " << max_error << (max_error <= tolerance ? " within" : " EXCEEDS") << " tolerance" << std::endl;
+	}
+}
+
+void riskSweepTest()
+{
+	/* sensitivity of each of the ten riskOpenClTest groups to a and to b, 1000
+	integer steps each way, Q of each.  The last two groups are P and Q sweeps
+	whose first term underflows and grows until it is representable, Q forward
+	in a with b = 1500 and P forward in b with a = 2000, around x = 0.5. */
+	const double ab[][3] = { { .5, .5, 1 }, { 5, 1, 1 }, { 1, 3, 1 }, { 2, 2, 1 }, { 2, 5, 1 }, { .1, .1, 1 }, { 0.01, 10, 1 }, { 10, 0.01, 1 }, { 100, 1, 1 }, { 1, 100, 1 },
+		{ 1, 1500, 1 }, { 2000, 1, 0 } };
+	const int num_groups = sizeof(ab) / sizeof(ab[0]);
+	const int num_x = 100;
+	const int steps = 1000;
+	const int num_sweeps = num_groups * num_x * 2;
+	const double tolerance = 1.0e-10;
+
+	std::unique_ptr<beta_sweep_request[]> sweeps(new beta_sweep_request[num_sweeps]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_sweeps]);
+	std::unique_ptr<double[]>
+		results_gpu(new double[num_sweeps * steps]),
+		results_cpu(new double[num_sweeps * steps]);
+
+	for (int i = 0; i < num_sweeps; i++)
+	{
+		sweeps[i].a = ab[i / (num_x * 2)][0];
+		sweeps[i].b = ab[i / (num_x * 2)][1];
+		sweeps[i].x = (double)((i / 2) % num_x + 1) / (double)(num_x + 1);
+		sweeps[i].sweep_b = i % 2;
+		sweeps[i].upper = (int)ab[i / (num_x * 2)][2];
+		sweeps[i].count = steps;
+		sweeps[i].reserved = 0;
+		sweeps[i].offset = (unsigned __int64)i * steps;
+	}
+
+	{
+		sys::benchmarker bmStock;
+		bmStock.start();
+		concurrency::parallel_for(0, num_sweeps, [&](int i)
+		{
+			for (int k = 0; k < steps; k++)
+			{
+				double a = sweeps[i].sweep_b ? sweeps[i].a : sweeps[i].a + k;
+				double b = sweeps[i].sweep_b ? sweeps[i].b + k : sweeps[i].b;
+				results_cpu[(size_t)sweeps[i].offset + k] = sweeps[i].upper ? gsl::gsl_cdf_beta_Q(sweeps[i].x, a, b) : gsl::gsl_cdf_beta_P(sweeps[i].x, a, b);
+			}
+		});
+		bmStock.stop();
+
+		std::cout << "Ran stock " << num_sweeps * steps << " beta P's and Q's in " << bmStock.getTotalSeconds() << " seconds" << std::endl;
+	}
+
+	beta_tiers tiers;
+	tiers.prepare(beta_exact);
+
+	sys::benchmarker bmGPU;
+	bmGPU.start();
+	tiers.sweep(sweeps.get(), responses.get(), num_sweeps, results_gpu.get(), num_sweeps * steps, tolerance);
+	bmGPU.stop();
+
+	double max_gpu = 0.0, anchors = 0.0;
+	for (int i = 0; i < num_sweeps * steps; i++)
+	{
+		max_gpu = std::max(max_gpu, fabs(results_gpu[i] - results_cpu[i]));
+	}
+	for (int i = 0; i < num_sweeps; i++)
+	{
+		anchors += responses[i].result;
+	}
+
+	sys::benchmarker bmCPU;
+	bmCPU.start();
+	concurrency::parallel_for(0, num_sweeps, [&](int i)
+	{
+		gsl::beta_sweep(sweeps[i].x, sweeps[i].a, sweeps[i].b, steps, sweeps[i].sweep_b, sweeps[i].upper, tolerance, results_cpu.get() + (size_t)sweeps[i].offset);
+	});
+	bmCPU.stop();
+
+	std::cout << "Ran CPU sweep " << num_sweeps * steps << " beta P's and Q's in " << bmCPU.getTotalSeconds() << " seconds" << std::endl;
+	std::cout << "Ran GPU sweep " << num_sweeps * steps << " beta P's and Q's in " << bmGPU.getTotalSeconds() << " seconds, " << anchors << " anchors, max difference from stock " << max_gpu << std::endl;
+}
+
+void riskGridTest()
+{
+	// the riskOpenClTest batch, sent as a grid description instead of ten million requests
+	const double a_values[] = { .5, 5, 1, 2, 2, .1, 0.01, 10, 100, 1 };
+	const double b_values[] = { .5, 1, 3, 2, 5, .1, 10, 0.01, 1, 100 };
+	const int num_pairs = sizeof(a_values) / sizeof(a_values[0]);
+	const int group_size = 1000000;
+	const int num_requests = num_pairs * group_size;
+
+	std::unique_ptr<double[]> results(new double[num_requests]);
+
+	beta_tiers tiers;
+	tiers.prepare(beta_standard);
+
+	sys::benchmarker bmGrid;
+	bmGrid.start();
+	tiers.evaluateGridQ(beta_standard, 0.0, 1.0 / group_size, group_size, a_values, b_values, num_pairs, results.get());
+	bmGrid.stop();
+
+	std::cout << "Ran grid " << num_requests << " beta Q's in " << bmGrid.getTotalSeconds() << " seconds, uploading "
+		<< sizeof(beta_grid) + sizeof(a_values) + sizeof(b_values) << " bytes" << std::endl;
+
+	double max_error = 0.0;
+	for (int i = 0; i < num_requests; i += 997)
+	{
+		int pair = i / group_size;
+		double x = (double)(i % group_size) / (double)group_size;
+		max_error = std::max(max_error, fabs(results[i] - gsl::gsl_cdf_beta_Q(x, a_values[pair], b_values[pair])));
+	}
+	std::cout << "Largest sampled difference from stock " << max_error << std::endl;
+
+	// a surface, every a against every b
+	const int num_ab = 100;
+	const int num_x = 1000;
+	std::unique_ptr<double[]> ab(new double[num_ab]);
+	std::unique_ptr<double[]> surface(new double[num_x * num_ab * num_ab]);
+	for (int i = 0; i < num_ab; i++)
+	{
+		ab[i] = 0.5 + i * 0.5;
+	}
+
+	sys::benchmarker bmSurface;
+	bmSurface.start();
+	tiers.evaluateProductQ(beta_standard, 0.5 / num_x, 1.0 / num_x, num_x, ab.get(), num_ab, ab.get(), num_ab, surface.get());
+	bmSurface.stop();
+
+	std::cout << "Ran surface " << num_x * num_ab * num_ab << " beta Q's in " << bmSurface.getTotalSeconds() << " seconds" << std::endl;
+}
+
+void riskReduceTest()
+{
+	// expected loss over a portfolio: each position's Q weighted by its exposure, only the aggregate comes back
+	const int num_requests = 1000000;
+	const double threshold = 0.99;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<double[]> exposures(new double[num_requests]);
+	std::unique_ptr<double[]> stock(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].x = (double)(i % 1000 + 1) / 1001.0;
+		requests[i].a = 0.5 + (i / 1000) % 50;
+		requests[i].b = 0.5 + (i / 50000) % 20;
+		exposures[i] = 1000.0 + i % 7919;
+	}
+
+	sys::benchmarker bmStock;
+	bmStock.start();
+	concurrency::parallel_for(0, num_requests, [&](int i)
+	{
+		stock[i] = gsl::gsl_cdf_beta_Q(requests[i].x, requests[i].a, requests[i].b);
+	});
+	beta_aggregate expected = beta_aggregate_identity();
+	for (int i = 0; i < num_requests; i++)
+	{
+		beta_aggregate single = { stock[i], exposures[i] * stock[i], stock[i], stock[i], i, i, stock[i] > threshold };
+		expected = beta_aggregate_combine(expected, single);
+	}
+	bmStock.stop();
+
+	std::cout << "Ran stock " << num_requests << " beta Q's and aggregated in " << bmStock.getTotalSeconds() << " seconds" << std::endl;
+
+	beta_tiers tiers;
+
+	sys::benchmarker bmReduce;
+	bmReduce.start();
+	beta_aggregate aggregate = tiers.reduceQ(requests.get(), num_requests, exposures.get(), threshold);
+	bmReduce.stop();
+
+	std::cout << "Ran GPU reduction of " << num_requests << " beta Q's in " << bmReduce.getTotalSeconds() << " seconds" << std::endl;
+	std::cout << "Expected loss " << aggregate.weighted_sum << " (stock " << expected.weighted_sum << "), mean Q " << aggregate.sum / num_requests
+		<< " (stock " << expected.sum / num_requests << ")" << std::endl;
+	std::cout << "Min Q " << aggregate.min << " at " << aggregate.argmin << " (stock " << expected.min << " at " << expected.argmin << "), max Q "
+		<< aggregate.max << " at " << aggregate.argmax << " (stock " << expected.max << " at " << expected.argmax << ")" << std::endl;
+	std::cout << aggregate.count << " over " << threshold << " (stock " << expected.count << ")" << std::endl;
+}
+
+void riskFilterTest()
+{
+	// limit monitoring: only the positions whose tail probability breaches their limit come back
+	const int num_requests = 10000000;
+	const double limit = 0.999;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<double[]> limits(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].x = (double)(i % 1000 + 1) / 1001.0;
+		requests[i].a = 0.5 + (i / 1000) % 50;
+		requests[i].b = 0.5 + (i / 50000) % 20;
+		limits[i] = limit - 0.001 * (i % 3);
+	}
+
+	beta_tiers tiers;
+	std::vector<beta_hit> hits, hits_each;
+
+	sys::benchmarker bmFilter;
+	bmFilter.start();
+	tiers.filterQ(requests.get(), num_requests, hits, NULL, limit, (size_t)1 << 21);
+	bmFilter.stop();
+
+	std::cout << "Filtered " << num_requests << " beta Q's in " << bmFilter.getTotalSeconds() << " seconds, " << hits.size()
+		<< " over " << limit << ", reading back " << hits.size() * sizeof(beta_hit) << " bytes" << std::endl;
+
+	tiers.filterQ(requests.get(), num_requests, hits_each, limits.get());
+	std::cout << hits_each.size() << " over their own limits" << std::endl;
+
+	std::unique_ptr<double[]> stock(new double[num_requests]);
+	concurrency::parallel_for(0, num_requests, [&](int i)
+	{
+		stock[i] = gsl::gsl_cdf_beta_Q(requests[i].x, requests[i].a, requests[i].b);
+	});
+
+	size_t expected = 0;
+	double max_error = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		expected += stock[i] > limit;
+	}
+	for (auto& hit : hits)
+	{
+		max_error = std::max(max_error, fabs(hit.value - stock[(size_t)hit.index]));
+	}
+	std::cout << "Stock finds " << expected << " over " << limit << ", largest hit difference from stock " << max_error << std::endl;
+}
+
+void riskQuantileTest()
+{
+	// the level each of the riskOpenClTest groups exceeds with probability 1%, 0.1% and so on
+	const double ab[][2] = { { .5, .5 }, { 5, 1 }, { 1, 3 }, { 2, 2 }, { 2, 5 }, { .1, .1 }, { 0.01, 10 }, { 10, 0.01 }, { 100, 1 }, { 1, 100 } };
+	const int num_groups = sizeof(ab) / sizeof(ab[0]);
+	const int group_size = 100000;
+	const int num_requests = num_groups * group_size;
+
+	std::unique_ptr<beta_quantile_request[]> requests(new beta_quantile_request[num_requests]);
+	std::unique_ptr<beta_request[]> forward(new beta_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_requests]);
+	std::unique_ptr<beta_response[]> forward_responses(new beta_response[num_requests]);
+	std::unique_ptr<double[]> stock(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].a = ab[i / group_size][0];
+		requests[i].b = ab[i / group_size][1];
+		requests[i].p = pow(10.0, -1.0 - 15.0 * (i % group_size) / group_size);
+	}
+
+	sys::benchmarker bmStock;
+	bmStock.start();
+	concurrency::parallel_for(0, num_requests, [&](int i)
+	{
+		stock[i] = gsl::gsl_cdf_beta_Qinv(requests[i].p, requests[i].a, requests[i].b);
+	});
+	bmStock.stop();
+
+	std::cout << "Ran CPU " << num_requests << " beta Q quantiles in " << bmStock.getTotalSeconds() << " seconds" << std::endl;
+
+	beta_tiers tiers;
+	tiers.prepare(beta_exact);
+
+	sys::benchmarker bmGPU;
+	bmGPU.start();
+	tiers.quantile(requests.get(), responses.get(), num_requests, true);
+	bmGPU.stop();
+
+	// the same batch forward, at the quantiles found, for the cost of one CDF
+	for (int i = 0; i < num_requests; i++)
+	{
+		forward[i].x = responses[i].result;
+		forward[i].a = requests[i].a;
+		forward[i].b = requests[i].b;
+	}
+
+	sys::benchmarker bmForward;
+	bmForward.start();
+	tiers.evaluateQ(beta_exact, forward.get(), forward_responses.get(), num_requests);
+	bmForward.stop();
+
+	double max_diff = 0.0, max_error = 0.0;
+	int failed = 0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		if (responses[i].result != responses[i].result) {
+			failed++;
+			continue;
+		}
+		max_diff = std::max(max_diff, fabs(responses[i].result - stock[i]));
+		max_error = std::max(max_error, fabs(forward_responses[i].result - requests[i].p) / requests[i].p);
+	}
+
+	std::cout << "Ran GPU " << num_requests << " beta Q quantiles in " << bmGPU.getTotalSeconds() << " seconds, the forward Q in "
+		<< bmForward.getTotalSeconds() << " seconds" << std::endl;
+	std::cout << failed << " did not converge, max difference from CPU " << max_diff << ", largest relative error in Q " << max_error << std::endl;
+}
+
+void riskFusedTest()
+{
+	// pricing wants the density and both tails of every position
+	const int num_requests = 1000000;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_fused[]> results_gpu(new beta_fused[num_requests]), results_cpu(new beta_fused[num_requests]), results_stock(new beta_fused[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].x = (double)(i % 1000 + 1) / 1001.0;
+		requests[i].a = 0.5 + (i / 1000) % 50;
+		requests[i].b = 0.5 + (i / 50000) % 20;
+	}
+
+	sys::benchmarker bmStock;
+	bmStock.start();
+	concurrency::parallel_for(0, num_requests, [&](int i)
+	{
+		results_stock[i].pdf = gsl::gsl_ran_beta_pdf(requests[i].x, requests[i].a, requests[i].b);
+		results_stock[i].P = gsl::gsl_cdf_beta_P(requests[i].x, requests[i].a, requests[i].b);
+		results_stock[i].Q = gsl::gsl_cdf_beta_Q(requests[i].x, requests[i].a, requests[i].b);
+	});
+	bmStock.stop();
+
+	std::cout << "Ran stock " << num_requests << " beta pdf, P and Q in " << bmStock.getTotalSeconds() << " seconds" << std::endl;
+
+	sys::benchmarker bmCPU;
+	bmCPU.start();
+	concurrency::parallel_for(0, num_requests, [&](int i)
+	{
+		gsl::gsl_cdf_beta_fused_result result;
+		gsl::gsl_cdf_beta_fused(requests[i].x, requests[i].a, requests[i].b, &result);
+		memcpy(&results_cpu[i], &result, sizeof(beta_fused));
+	});
+	bmCPU.stop();
+
+	std::cout << "Ran CPU fused " << num_requests << " in " << bmCPU.getTotalSeconds() << " seconds" << std::endl;
+
+	beta_tiers tiers;
+	tiers.prepare(beta_exact);
+
+	sys::benchmarker bmGPU;
+	bmGPU.start();
+	tiers.fused(requests.get(), results_gpu.get(), num_requests);
+	bmGPU.stop();
+
+	std::cout << "Ran GPU fused " << num_requests << " in " << bmGPU.getTotalSeconds() << " seconds" << std::endl;
+
+	double max_cpu = 0.0, max_gpu = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		max_cpu = std::max(max_cpu, fabs(results_cpu[i].P - results_stock[i].P) + fabs(results_cpu[i].Q - results_stock[i].Q) + fabs(results_cpu[i].pdf - results_stock[i].pdf) / results_stock[i].pdf);
+		max_gpu = std::max(max_gpu, fabs(results_gpu[i].P - results_stock[i].P) + fabs(results_gpu[i].Q - results_stock[i].Q) + fabs(results_gpu[i].pdf - results_stock[i].pdf) / results_stock[i].pdf);
+	}
+
+	std::cout << "Largest difference from stock, CPU " << max_cpu << " GPU " << max_gpu << std::endl;
+}
+
+void riskGammaTest()
+{
+	// loss severities, the chance a claim of shape a and scale b goes past x
+	const int num_requests = 1000000;
+	const int chunk = 10000;
+
+	std::unique_ptr<gamma_request[]> requests(new gamma_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_requests]);
+	std::unique_ptr<double[]> results_cpu(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].a = 0.1 + (double)((i * 7919) % 2000) / 10.0;
+		requests[i].b = 1000.0 * (1 + i % 5);
+		requests[i].x = requests[i].a * requests[i].b * (double)((i * 104729) % 400 + 1) / 100.0;
+	}
+
+	sys::benchmarker bmCPU;
+	bmCPU.start();
+	concurrency::parallel_for(0, num_requests / chunk, [&](int c)
+	{
+		gsl::gsl_cdf_gamma_Q_array(&requests[c * chunk].x, &requests[c * chunk].a, &requests[c * chunk].b, 3, &results_cpu[c * chunk], chunk);
+	});
+	bmCPU.stop();
+
+	std::cout << "Ran CPU " << num_requests << " gamma Q in " << bmCPU.getTotalSeconds() << " seconds" << std::endl;
+
+	gamma_engine engine;
+	engine.prepare();
+
+	sys::benchmarker bmGPU;
+	bmGPU.start();
+	engine.evaluate(gamma_upper, requests.get(), responses.get(), num_requests);
+	bmGPU.stop();
+
+	std::cout << "Ran GPU " << num_requests << " gamma Q in " << bmGPU.getTotalSeconds() << " seconds, "
+		<< engine.regime_count(gamma_series) << " series, "
+		<< engine.regime_count(gamma_continued_fraction) << " continued fraction, "
+		<< engine.regime_count(gamma_large_x) << " large x, "
+		<< engine.regime_count(gamma_asymptotic) << " asymptotic" << std::endl;
+
+	double max_gpu = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		max_gpu = std::max(max_gpu, fabs(responses[i].result - results_cpu[i]));
+	}
+
+	std::cout << "Largest difference from CPU " << max_gpu << std::endl;
+
+	// a goodness of fit check on the same batch size
+	std::unique_ptr<chisq_request[]> chisq(new chisq_request[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		chisq[i].nu = 1 + i % 100;
+		chisq[i].x = chisq[i].nu * (double)(i % 1000 + 1) / 500.0;
+	}
+
+	engine.evaluate(gamma_upper, chisq.get(), responses.get(), num_requests);
+
+	double max_chisq = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		max_chisq = std::max(max_chisq, fabs(responses[i].result - gsl::gsl_cdf_chisq_Q(chisq[i].x, chisq[i].nu)));
+	}
+
+	std::cout << "Largest chi-square difference from CPU " << max_chisq << std::endl;
+}
+
+void riskTDistTest()
+{
+	// backtest statistics, the p-value of every strategy's mean return t statistic
+	const int num_requests = 1000000;
+	const int chunk = 10000;
+
+	std::unique_ptr<tdist_request[]> requests(new tdist_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_requests]);
+	std::unique_ptr<double[]> results_cpu(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].nu = 1 + (i / 1000) % 250;
+		requests[i].x = (double)(i % 1000 - 500) / 25.0;
+	}
+
+	sys::benchmarker bmCPU;
+	bmCPU.start();
+	concurrency::parallel_for(0, num_requests / chunk, [&](int c)
+	{
+		gsl::gsl_cdf_tdist_two_sided_array(&requests[c * chunk].x, &requests[c * chunk].nu, 2, &results_cpu[c * chunk], chunk);
+	});
+	bmCPU.stop();
+
+	std::cout << "Ran CPU " << num_requests << " two sided t in " << bmCPU.getTotalSeconds() << " seconds" << std::endl;
+
+	beta_tiers tiers;
+	tiers.prepare(beta_exact);
+
+	sys::benchmarker bmGPU;
+	bmGPU.start();
+	tiers.tdist(beta_two_sided, requests.get(), responses.get(), num_requests);
+	bmGPU.stop();
+
+	std::cout << "Ran GPU " << num_requests << " two sided t in " << bmGPU.getTotalSeconds() << " seconds" << std::endl;
+
+	// p-values of interest are small, so compare relative to the value
+	double max_gpu = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		max_gpu = std::max(max_gpu, fabs(responses[i].result - results_cpu[i]) / results_cpu[i]);
+	}
+
+	std::cout << "Largest relative difference from CPU " << max_gpu << std::endl;
+
+	// variance ratios between pairs of return windows
+	std::unique_ptr<fdist_request[]> ratios(new fdist_request[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		ratios[i].nu1 = 5 + (i / 1000) % 100;
+		ratios[i].nu2 = 5 + (i / 100000) * 20;
+		ratios[i].x = (double)(i % 1000 + 1) / 200.0;
+	}
+
+	tiers.fdist(beta_upper, ratios.get(), responses.get(), num_requests);
+
+	double max_f = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		double Q = gsl::gsl_cdf_fdist_Q(ratios[i].x, ratios[i].nu1, ratios[i].nu2);
+		max_f = std::max(max_f, fabs(responses[i].result - Q) / Q);
+	}
+
+	std::cout << "Largest relative F difference from CPU " << max_f << std::endl;
+}
+
+void riskDefaultCountTest()
+{
+	// the chance of more than k defaults in a pool of n names
+	const int num_requests = 1000000;
+
+	std::unique_ptr<binomial_request[]> requests(new binomial_request[num_requests]);
+	std::unique_ptr<beta_binomial_request[]> correlated(new beta_binomial_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses(new beta_response[num_requests]);
+	std::unique_ptr<double[]> results_cpu(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		requests[i].n = 100 * (1 + (i / 1000) % 1000);
+		requests[i].p = 0.001 * (1 + (i / 1000) % 50);
+		requests[i].k = (int)(requests[i].n * requests[i].p * (i % 1000) / 250.0);
+
+		// a default correlation of about 0.05 around the same rate
+		correlated[i].n = requests[i].n;
+		correlated[i].k = requests[i].k;
+		correlated[i].alpha = requests[i].p * 19.0;
+		correlated[i].beta = (1.0 - requests[i].p) * 19.0;
+	}
+
+	sys::benchmarker bmCPU;
+	bmCPU.start();
+	concurrency::parallel_for(0, num_requests, [&](int i)
+	{
+		results_cpu[i] = gsl::gsl_cdf_binomial_Q(requests[i].k, requests[i].p, requests[i].n);
+	});
+	bmCPU.stop();
+
+	std::cout << "Ran CPU " << num_requests << " binomial Q in " << bmCPU.getTotalSeconds() << " seconds" << std::endl;
+
+	beta_tiers tiers;
+
+	sys::benchmarker bmGPU;
+	bmGPU.start();
+	tiers.binomial(requests.get(), responses.get(), num_requests, true);
+	bmGPU.stop();
+
+	std::cout << "Ran GPU " << num_requests << " binomial Q in " << bmGPU.getTotalSeconds() << " seconds" << std::endl;
+
+	double max_gpu = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		max_gpu = std::max(max_gpu, fabs(responses[i].result - results_cpu[i]));
+	}
+
+	std::cout << "Largest difference from CPU " << max_gpu << std::endl;
+
+	sys::benchmarker bmCorrelated;
+	bmCorrelated.start();
+	tiers.beta_binomial(correlated.get(), responses.get(), num_requests, true);
+	bmCorrelated.stop();
+
+	double max_correlated = 0.0, fatter = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		double Q = gsl::gsl_cdf_beta_binomial_Q(correlated[i].k, correlated[i].n, correlated[i].alpha, correlated[i].beta);
+		max_correlated = std::max(max_correlated, fabs(responses[i].result - Q));
+		fatter = std::max(fatter, Q - results_cpu[i]);
+	}
+
+	std::cout << "Ran GPU " << num_requests << " beta-binomial Q in " << bmCorrelated.getTotalSeconds() << " seconds, largest difference from CPU "
+		<< max_correlated << ", largest tail added by correlation " << fatter << std::endl;
+}
+
+void riskSpecialTest()
+{
+	// calibration asks for digamma and erfc of every observation
+	const int num_requests = 1000000;
+	const int chunk = 10000;
+
+	std::unique_ptr<double[]> x(new double[num_requests]), q(new double[num_requests]);
+	std::unique_ptr<double[]> values_gpu(new double[num_requests]), values_cpu(new double[num_requests]);
+	std::unique_ptr<int[]> order(new int[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		x[i] = 0.001 + (double)(i % 100000) / 1000.0;
+		q[i] = 1.0 + (i % 7);
+		order[i] = i % 4;
+	}
+
+	special_engine engine;
+	engine.prepare();
+
+	const char *names[special_function_count] = { "digamma", "trigamma", "erfc", "lngamma" };
+	void (*cpu[special_function_count])(const double *, double *, const size_t) = { gsl::gsl_sf_psi_array, gsl::gsl_sf_psi_1_array, gsl::gsl_sf_erfc_array, gsl::gsl_sf_lngamma_array };
+
+	for (int f = 0; f < special_function_count; f++)
+	{
+		sys::benchmarker bmCPU;
+		bmCPU.start();
+		concurrency::parallel_for(0, num_requests / chunk, [&](int c)
+		{
+			cpu[f](&x[c * chunk], &values_cpu[c * chunk], chunk);
+		});
+		bmCPU.stop();
+
+		sys::benchmarker bmGPU;
+		bmGPU.start();
+		engine.evaluate((special_function)f, x.get(), values_gpu.get(), num_requests);
+		bmGPU.stop();
+
+		double max_gpu = 0.0;
+		for (int i = 0; i < num_requests; i++)
+		{
+			max_gpu = std::max(max_gpu, fabs(values_gpu[i] - values_cpu[i]) / std::max(1.0, fabs(values_cpu[i])));
+		}
+
+		std::cout << "Ran " << num_requests << " " << names[f] << " CPU " << bmCPU.getTotalSeconds() << " GPU " << bmGPU.getTotalSeconds()
+			<< " seconds, largest difference " << max_gpu << std::endl;
+	}
+
+	engine.psi_n(order.get(), x.get(), values_gpu.get(), num_requests);
+	gsl::gsl_sf_psi_n_array(order.get(), x.get(), values_cpu.get(), num_requests);
+
+	double max_psi_n = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		max_psi_n = std::max(max_psi_n, fabs(values_gpu[i] - values_cpu[i]) / std::max(1.0, fabs(values_cpu[i])));
+	}
+
+	engine.hzeta(q.get(), x.get(), values_gpu.get(), num_requests);
+	gsl::gsl_sf_hzeta_array(q.get(), x.get(), values_cpu.get(), num_requests);
+
+	double max_hzeta = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		if (values_cpu[i] == values_cpu[i]) {
+			max_hzeta = std::max(max_hzeta, fabs(values_gpu[i] - values_cpu[i]) / std::max(1.0, fabs(values_cpu[i])));
+		}
+	}
+
+	std::cout << "Largest psi_n difference " << max_psi_n << ", hzeta difference " << max_hzeta << std::endl;
+}
+
+void riskChebyshevTest()
+{
+	// one tranche's (a, b), priced at every point of a fine x grid
+	const int num_requests = 10000000;
+	const double a = 2.5, b = 7.0;
+
+	std::unique_ptr<double[]> x(new double[num_requests]);
+	std::unique_ptr<double[]> values_cpu(new double[num_requests]), values_gpu(new double[num_requests]), values_stock(new double[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		x[i] = (i + 0.5) / num_requests;
+	}
+
+	beta_chebyshev table;
+
+	sys::benchmarker bmBuild;
+	bmBuild.start();
+	table.open("beta_2.5_7.cheb", a, b, [](double x, double a, double b) { return gsl::gsl_cdf_beta_P(x, a, b); });
+	bmBuild.stop();
+
+	std::cout << "Table of " << table.piece_count() << " pieces ready in " << bmBuild.getTotalSeconds() << " seconds, estimated error " << table.error_bound() << std::endl;
+
+	sys::benchmarker bmStock;
+	bmStock.start();
+	concurrency::parallel_for(0, num_requests, [&](int i)
+	{
+		values_stock[i] = gsl::gsl_cdf_beta_Q(x[i], a, b);
+	});
+	bmStock.stop();
+
+	std::cout << "Ran stock " << num_requests << " beta Q's in " << bmStock.getTotalSeconds() << " seconds" << std::endl;
+
+	sys::benchmarker bmCPU;
+	bmCPU.start();
+	table.evaluate(x.get(), values_cpu.get(), num_requests, true);
+	bmCPU.stop();
+
+	std::cout << "Ran CPU Chebyshev " << num_requests << " in " << bmCPU.getTotalSeconds() << " seconds" << std::endl;
+
+	sys::benchmarker bmGPU;
+	bmGPU.start();
+	table.evaluateGpu(x.get(), values_gpu.get(), num_requests, true);
+	bmGPU.stop();
+
+	std::cout << "Ran GPU Chebyshev " << num_requests << " in " << bmGPU.getTotalSeconds() << " seconds" << std::endl;
+
+	double max_cpu = 0.0, max_gpu = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		max_cpu = std::max(max_cpu, fabs(values_cpu[i] - values_stock[i]));
+		max_gpu = std::max(max_gpu, fabs(values_gpu[i] - values_stock[i]));
+	}
+
+	std::cout << "Largest difference from stock, CPU " << max_cpu << " GPU " << max_gpu << std::endl;
+}
+
+void riskSpecializeTest()
+{
+	// a few tranches priced again and again, as a scenario loop does
+	const int num_points = 1000000;
+	const int num_batches = 24;
+	const double pairs[4][2] = { { 2.5, 7.0 }, { 0.75, 12.0 }, { 30.0, 45.0 }, { 4.0, 4.0 } };
+
+	std::unique_ptr<double[]> x(new double[num_points]);
+	std::unique_ptr<double[]> values_generic(new double[num_points]), values_spec(new double[num_points]);
+
+	for (int i = 0; i < num_points; i++)
+	{
+		x[i] = (i + 0.5) / num_points;
+	}
+
+	// a threshold no pair reaches keeps every batch on the generic build
+	beta_specializer generic(num_batches + 1);
+	beta_specializer specializer(4, 16, "betaspec_");
+	generic.prepare();
+	specializer.prepare();
+
+	double seconds_generic = 0.0, seconds_spec = 0.0, max_diff = 0.0;
+	int specialized = 0;
+
+	for (int batch = 0; batch < num_batches; batch++)
+	{
+		double a = pairs[batch % 4][0], b = pairs[batch % 4][1];
+		double ln_beta = gsl::gsl_sf_lnbeta(a, b);
+
+		sys::benchmarker bmGeneric;
+		bmGeneric.start();
+		generic.evaluate(a, b, ln_beta, x.get(), values_generic.get(), num_points, true);
+		bmGeneric.stop();
+
+		size_t built = specializer.compiled_count() + specializer.loaded_count();
+
+		sys::benchmarker bmSpec;
+		bmSpec.start();
+		bool ran_variant = specializer.evaluate(a, b, ln_beta, x.get(), values_spec.get(), num_points, true);
+		bmSpec.stop();
+
+		// only batches that ran a variant already built are timed, the builds are counted below
+		if (ran_variant && built == specializer.compiled_count() + specializer.loaded_count()) {
+			specialized++;
+			seconds_generic += bmGeneric.getTotalSeconds();
+			seconds_spec += bmSpec.getTotalSeconds();
+		}
+
+		for (int i = 0; i < num_points; i++)
+		{
+			max_diff = std::max(max_diff, fabs(values_spec[i] - values_generic[i]));
+		}
+	}
+
+	std::cout << specializer.variant_count() << " variants, " << specializer.compiled_count() << " compiled, " << specializer.loaded_count() << " loaded from binaries" << std::endl;
+	std::cout << "Over the " << specialized << " specialized batches, generic " << seconds_generic << " seconds, specialized " << seconds_spec << " seconds" << std::endl;
+	std::cout << "Largest difference " << max_diff << std::endl;
+}
+
+void riskStatusTest()
+{
+	// a clean portfolio with a few bad rows: parameters that never got filled in, and tails that underflow
+	const int num_requests = 4000000;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses_plain(new beta_response[num_requests]), responses_checked(new beta_response[num_requests]);
+	std::unique_ptr<unsigned char[]> status(new unsigned char[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		auto req = &requests[i];
+		req->x = (i % 9973 + 0.5) / 9973.0;
+		req->a = 0.5 + (i % 61) * 0.75;
+		req->b = 1.0 + (i % 47) * 1.25;
+		if (i % 100003 == 0) {
+			req->a = 0.0;
+		}
+		else if (i % 250007 == 0) {
+			req->x = 0.5;
+			req->a = 3.0;
+			req->b = 2.0e5;
+		}
+	}
+
+	beta_tiers tiers;
+	tiers.prepare(beta_exact);
+
+	sys::benchmarker bmPlain;
+	bmPlain.start();
+	tiers.evaluateQ(beta_exact, requests.get(), responses_plain.get(), num_requests);
+	bmPlain.stop();
+
+	std::vector<beta_failure> failures;
+	sys::benchmarker bmChecked;
+	bmChecked.start();
+	beta_status_summary summary = tiers.evaluateChecked(requests.get(), responses_checked.get(), num_requests, true, failures);
+	bmChecked.stop();
+
+	std::vector<beta_failure> counted_only;
+	sys::benchmarker bmStatus;
+	bmStatus.start();
+	tiers.evaluateChecked(requests.get(), responses_checked.get(), num_requests, true, counted_only, status.get(), 0);
+	bmStatus.stop();
+
+	size_t mismatched = 0, status_failed = 0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		double plain = responses_plain[i].result, checked = responses_checked[i].result;
+		if (memcmp(&plain, &checked, sizeof(double))) {
+			mismatched++;
+		}
+		if (status[i] != beta_ok) {
+			status_failed++;
+		}
+	}
+
+	size_t repaired = tiers.retryChecked(requests.get(), responses_checked.get(), true, failures);
+
+	std::cout << summary.failed << " of " << summary.count << " failed: " << summary.by_status[beta_domain] << " domain, " << summary.by_status[beta_maxiter] << " max iterations, "
+		<< summary.by_status[beta_underflow] << " underflow" << (summary.truncated ? " (list truncated)" : "") << std::endl;
+	std::cout << failures.size() << " still listed after retrying, " << repaired << " repaired" << std::endl;
+	std::cout << "Plain " << bmPlain.getTotalSeconds() << " seconds, checked " << bmChecked.getTotalSeconds() << " seconds, with per request status " << bmStatus.getTotalSeconds() << " seconds" << std::endl;
+	std::cout << mismatched << " results differ from the plain batch, " << status_failed << " failures in the status bytes" << std::endl;
+}
+
+void riskChunkTest()
+{
+	// more requests than many devices will take in one buffer
+	const int num_requests = 40000000;
+	const size_t small_chunk = 1000000;
+
+	io::file_data fdNative("nativebeta.cl");
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_response[]> responses_whole(new beta_response[num_requests]), responses_small(new beta_response[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		auto req = &requests[i];
+		req->x = (i % 9973 + 0.5) / 9973.0;
+		req->a = 0.5 + (i % 61) * 0.75;
+		req->b = 1.0 + (i % 47) * 1.25;
+	}
+
+	openClProgram<beta_request, beta_response> programGpu(fdNative.get_data(), CL_DEVICE_TYPE_GPU);
+
+	sys::benchmarker bmWhole;
+	bmWhole.start();
+	programGpu.RunKernel("incBetaQ", requests.get(), responses_whole.get(), num_requests, 1);
+	bmWhole.stop();
+	size_t whole_chunk = programGpu.GetLastChunk();
+
+	programGpu.SetChunkLimit(small_chunk);
+	sys::benchmarker bmSmall;
+	bmSmall.start();
+	programGpu.RunKernel("incBetaQ", requests.get(), responses_small.get(), num_requests, 1);
+	bmSmall.stop();
+
+	size_t mismatched = 0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		if (responses_whole[i].result != responses_small[i].result) {
+			mismatched++;
+		}
+	}
+
+	std::cout << "Ran " << num_requests << " beta Q's in chunks of " << whole_chunk << " in " << bmWhole.getTotalSeconds() << " seconds" << std::endl;
+	std::cout << "In chunks of " << small_chunk << " in " << bmSmall.getTotalSeconds() << " seconds, " << mismatched << " results differ" << std::endl;
+}
+
+void riskResidentTest()
+{
+	const int num_requests = 4000000;
+	const int max_iter = 64;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<beta_response[]> P(new beta_response[num_requests]), Q(new beta_response[num_requests]),
+		pdf(new beta_response[num_requests]), check(new beta_response[num_requests]);
+	std::unique_ptr<beta_response[]> P_each(new beta_response[num_requests]), Q_each(new beta_response[num_requests]),
+		pdf_each(new beta_response[num_requests]), check_each(new beta_response[num_requests]);
+
+	for (int i = 0; i < num_requests; i++)
+	{
+		auto req = &requests[i];
+		req->x = (i % 9973 + 0.5) / 9973.0;
+		req->a = 0.5 + (i % 61) * 0.75;
+		req->b = 1.0 + (i % 47) * 1.25;
+	}
+
+	gsl_source fdGsl;
+	openClProgram<beta_request, beta_response> programGpu(fdGsl.get_data(), CL_DEVICE_TYPE_GPU);
+
+	// each launch uploads the requests again, and the check uploads P as well
+	sys::benchmarker bmEach;
+	bmEach.start();
+	programGpu.RunKernel("gsl_cdf_beta_P_cl", requests.get(), P_each.get(), num_requests, 1);
+	programGpu.RunKernel("gsl_cdf_beta_Q_cl", requests.get(), Q_each.get(), num_requests, 1);
+	programGpu.RunKernel("gsl_ran_beta_pdf_cl", requests.get(), pdf_each.get(), num_requests, 1);
+	programGpu.RunKernel("gsl_cdf_beta_Pinv_check_cl", requests.get(), check_each.get(), num_requests, 1, openClInEach(P_each.get()), max_iter);
+	bmEach.stop();
+
+	beta_tiers tiers;
+	tiers.prepare(beta_exact);
+
+	sys::benchmarker bmResident;
+	bmResident.start();
+	tiers.profile(requests.get(), num_requests, P.get(), Q.get(), pdf.get(), check.get(), max_iter);
+	bmResident.stop();
+
+	size_t mismatched = 0;
+	double worst_check = 0.0;
+	for (int i = 0; i < num_requests; i++)
+	{
+		if (P[i].result != P_each[i].result || Q[i].result != Q_each[i].result || pdf[i].result != pdf_each[i].result || check[i].result != check_each[i].result) {
+			mismatched++;
+		}
+		// past the median P rounds toward 1 and no longer pins x down, so only the lower half is checked
+		if (P[i].result <= 0.5) {
+			worst_check = std::max(worst_check, fabs(check[i].result));
+		}
+	}
+
+	std::cout << "Uploading for each kernel " << bmEach.getTotalSeconds() << " seconds, resident " << bmResident.getTotalSeconds() << " seconds" << std::endl;
+	std::cout << mismatched << " results differ, largest quantile check error with P <= 0.5 " << worst_check << std::endl;
+}
+
+void riskGraphTest()
+{
+	// a day's scenarios, each a batch of the same shape run through one graph
+	const int num_requests = 1000000;
+	const int num_batches = 8;
+	const double threshold = 0.99;
+
+	std::unique_ptr<beta_request[]> requests(new beta_request[num_requests]);
+	std::unique_ptr<double[]> exposures(new double[num_requests]);
+	std::unique_ptr<beta_response[]> Q(new beta_response[num_requests]), Q_each(new beta_response[num_requests]);
+
+	beta_tiers tiers;
+	tiers.prepare(beta_exact);
+
+	sys::benchmarker bmBuild;
+	bmBuild.start();
+	beta_regime_graph graph(num_requests);
+	bmBuild.stop();
+
+	sys::benchmarker bmEach, bmGraph;
+	size_t mismatched = 0, aggregates_differ = 0;
+
+	for (int batch = 0; batch < num_batches; batch++)
+	{
+		for (int i = 0; i < num_requests; i++)
+		{
+			requests[i].x = (double)((i + batch * 137) % 1003) / 1001.0;
+			requests[i].a = 0.5 + (i / 1000 + batch) % 50;
+			requests[i].b = 0.5 + (i / 50000 + batch) % 20;
+			exposures[i] = 1000.0 + (i + batch) % 7919;
+		}
+		if (!batch) {
+			// builds the reduction program, so the build is not timed with the first batch
+			tiers.reduceQ(requests.get(), 1);
+		}
+
+		// two launches, each uploading the batch and waited on before the next
+		bmEach.start();
+		tiers.evaluateQ(beta_exact, requests.get(), Q_each.get(), num_requests);
+		beta_aggregate expected = tiers.reduceQ(requests.get(), num_requests, exposures.get(), threshold);
+		bmEach.stop();
+
+		bmGraph.start();
+		beta_aggregate aggregate = graph.evaluate(requests.get(), Q.get(), exposures.get(), threshold);
+		bmGraph.stop();
+
+		for (int i = 0; i < num_requests; i++)
+		{
+			if (Q[i].result != Q_each[i].result) {
+				mismatched++;
+			}
+		}
+		if (memcmp(&aggregate, &expected, sizeof(aggregate))) {
+			aggregates_differ++;
+		}
+	}
+
+	std::cout << "Built the regime graph over " << graph.lane_count() << " queues in " << bmBuild.getTotalSeconds() << " seconds" << std::endl;
+	std::cout << "Ran " << num_batches << " batches of " << num_requests << " beta Q's with their aggregates, separate launches "
+		<< bmEach.getTotalSeconds() << " seconds, graph " << bmGraph.getTotalSeconds() << " seconds" << std::endl;
+	std::cout << "Last batch by regime: edge " << graph.regime_count(beta_regime_edge) << ", direct " << graph.regime_count(beta_regime_direct)
+		<< ", reflected " << graph.regime_count(beta_regime_reflected) << std::endl;
+	std::cout << mismatched << " results and " << aggregates_differ << " aggregates differ" << std::endl;
+}
+
 int main()
 {
 	try
 	{
 		riskOpenClTest();
 		//simpleOpenCLTest();
+		//riskCacheTest();
+		//riskDedupTest();
+		//riskLnbetaTableTest();
+		//riskPrecisionTest();
+		//riskRefineTest();
+		//riskSweepTest();
+		//riskGridTest();
+		//riskReduceTest();
+		//riskFilterTest();
+		//riskQuantileTest();
+		//riskFusedTest();
+		//riskGammaTest();
+		//riskTDistTest();
+		//riskDefaultCountTest();
+		//riskSpecialTest();
+		//riskChebyshevTest();
+		//riskSpecializeTest();
+		//riskStatusTest();
+		//riskChunkTest();
+		//riskResidentTest();
+		//riskGraphTest();
 	}
 	catch (std::exception& exc)
 	{
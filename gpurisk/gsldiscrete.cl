@@ -0,0 +1,72 @@
+/*
+ * Binomial, negative binomial and beta-binomial kernels over
+ * gsl_cdf_binomial_P and friends, which gslbeta.cl has from gslcore.h.
+ * Build after gslbeta.cl; requests are answered with gsl_cdf_beta_response.
+ */
+
+/* k successes in n trials of probability p, or for the negative binomial
+k failures before the n-th success. */
+struct gsl_cdf_binomial_request
+{
+	double p;
+	int k, n;
+};
+
+typedef struct gsl_cdf_binomial_request gsl_cdf_binomial_request;
+
+/* k defaults among n names with a beta(alpha, beta) default probability */
+struct gsl_cdf_beta_binomial_request
+{
+	double alpha, beta;
+	int k, n;
+};
+
+typedef struct gsl_cdf_beta_binomial_request gsl_cdf_beta_binomial_request;
+
+__kernel void gsl_cdf_binomial_P_cl(__global gsl_cdf_binomial_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_binomial_P(request[threadId].k, request[threadId].p, request[threadId].n);
+}
+
+__kernel void gsl_cdf_binomial_Q_cl(__global gsl_cdf_binomial_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_binomial_Q(request[threadId].k, request[threadId].p, request[threadId].n);
+}
+
+__kernel void gsl_cdf_negative_binomial_P_cl(__global gsl_cdf_binomial_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_negative_binomial_P(request[threadId].k, request[threadId].p, request[threadId].n);
+}
+
+__kernel void gsl_cdf_negative_binomial_Q_cl(__global gsl_cdf_binomial_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_negative_binomial_Q(request[threadId].k, request[threadId].p, request[threadId].n);
+}
+
+__kernel void gsl_cdf_beta_binomial_P_cl(__global gsl_cdf_beta_binomial_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_beta_binomial_P(request[threadId].k, request[threadId].n, request[threadId].alpha, request[threadId].beta);
+}
+
+__kernel void gsl_cdf_beta_binomial_Q_cl(__global gsl_cdf_beta_binomial_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_beta_binomial_Q(request[threadId].k, request[threadId].n, request[threadId].alpha, request[threadId].beta);
+}
@@ -0,0 +1,105 @@
+/*
+ * Gamma and chi-square distributions on the gamma_inc port in gslbeta.cl,
+ * the same functions as gsl_cdf_gamma_P and friends in gslport.h.  Build
+ * after gslbeta.cl; requests are answered with gsl_cdf_beta_response.
+ *
+ * The incomplete gamma functions switch between a series, a continued
+ * fraction, a large x form and a uniform asymptotic expansion.  gammahost.h
+ * sorts a batch by regime before it is sent, so the work items of a wavefront
+ * mostly run the same branch.
+ */
+
+double
+gsl_cdf_gamma_P(double x, double a, double b)
+{
+	double y = x / b;
+
+	if (x <= 0.0)
+	{
+		return 0.0;
+	}
+
+	if (y > a)
+	{
+		return 1.0 - gsl_sf_gamma_inc_Q(a, y);
+	}
+
+	return gsl_sf_gamma_inc_P(a, y);
+}
+
+double
+gsl_cdf_gamma_Q(double x, double a, double b)
+{
+	double y = x / b;
+
+	if (x <= 0.0)
+	{
+		return 1.0;
+	}
+
+	if (y < a)
+	{
+		return 1.0 - gsl_sf_gamma_inc_P(a, y);
+	}
+
+	return gsl_sf_gamma_inc_Q(a, y);
+}
+
+double
+gsl_cdf_chisq_P(double x, double nu)
+{
+	return gsl_cdf_gamma_P(x, nu / 2.0, 2.0);
+}
+
+double
+gsl_cdf_chisq_Q(double x, double nu)
+{
+	return gsl_cdf_gamma_Q(x, nu / 2.0, 2.0);
+}
+
+/* b is the scale */
+struct gsl_cdf_gamma_request
+{
+	double x, a, b;
+};
+
+typedef struct gsl_cdf_gamma_request gsl_cdf_gamma_request;
+
+struct gsl_cdf_chisq_request
+{
+	double x, nu;
+};
+
+typedef struct gsl_cdf_chisq_request gsl_cdf_chisq_request;
+
+__kernel void gsl_cdf_gamma_P_cl(__global gsl_cdf_gamma_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_gamma_P(request[threadId].x, request[threadId].a, request[threadId].b);
+}
+
+__kernel void gsl_cdf_gamma_Q_cl(__global gsl_cdf_gamma_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_gamma_Q(request[threadId].x, request[threadId].a, request[threadId].b);
+}
+
+__kernel void gsl_cdf_chisq_P_cl(__global gsl_cdf_chisq_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_chisq_P(request[threadId].x, request[threadId].nu);
+}
+
+__kernel void gsl_cdf_chisq_Q_cl(__global gsl_cdf_chisq_request *request, __global gsl_cdf_beta_response *response)
+{
+	int threadId = get_global_id(0);
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = gsl_cdf_chisq_Q(request[threadId].x, request[threadId].nu);
+}
@@ -0,0 +1,214 @@
+/*
+ * Beta CDF kernels fused with work group reductions and compaction.  Build
+ * after openClReduceSource and gslbeta.cl, launch the *_reduce_cl kernels
+ * with RunReduce and the *_filter_cl kernels with RunCompact.  Each work
+ * item folds the requests from its global id on in steps of the global size
+ * into its own aggregate, and each group reduces those to a single 56 byte
+ * gsl_cdf_beta_aggregate.  RunReduce runs a few groups a compute unit at any
+ * batch size, so a batch reads back a few kilobytes against 16 bytes a
+ * request for responses; the host folds them.
+ *
+ * weight[i] scales request i in weighted_sum when weighted is set, for
+ * instance an exposure, so weighted_sum is an expected loss.  count is the
+ * number of results above threshold.
+ */
+
+struct gsl_cdf_beta_aggregate
+{
+	double sum;
+	double weighted_sum;
+	double min;
+	double max;
+	long argmin;
+	long argmax;
+	long count;
+};
+
+typedef struct gsl_cdf_beta_aggregate gsl_cdf_beta_aggregate;
+
+// an aggregate of nothing, which every item starts from
+void gsl_cdf_beta_aggregate_start(gsl_cdf_beta_aggregate *own)
+{
+	own->sum = 0.0;
+	own->weighted_sum = 0.0;
+	own->min = INFINITY;
+	own->max = -INFINITY;
+	own->argmin = -1;
+	own->argmax = -1;
+	own->count = 0;
+}
+
+/* Folds value, the result of request index, into an item's aggregate.  An
+item sees its indices in increasing order, but ties still go to the lower
+index so that -1 loses them. */
+void gsl_cdf_beta_aggregate_add(gsl_cdf_beta_aggregate *own, double value, long index, double weight, double threshold)
+{
+	own->sum += value;
+	own->weighted_sum += weight * value;
+	if (value < own->min || (value == own->min && (ulong)index < (ulong)own->argmin)) {
+		own->min = value;
+		own->argmin = index;
+	}
+	if (value > own->max || (value == own->max && (ulong)index < (ulong)own->argmax)) {
+		own->max = value;
+		own->argmax = index;
+	}
+	own->count += value > threshold;
+}
+
+/* __local arrays may only be declared at kernel scope, so the kernels own the scratch */
+void gsl_cdf_beta_aggregate_group(const gsl_cdf_beta_aggregate *own, __global gsl_cdf_beta_aggregate *partial,
+	__local double *scratch, __local long *scratch_index)
+{
+	long argmin, argmax;
+
+	double sum = reduce_sum(own->sum, scratch);
+	double weighted_sum = reduce_sum(own->weighted_sum, scratch);
+	double min = reduce_min(own->min, own->argmin, scratch, scratch_index, &argmin);
+	double max = reduce_max(own->max, own->argmax, scratch, scratch_index, &argmax);
+	long count = reduce_count(own->count, scratch_index);
+
+	if (get_local_id(0) == 0) {
+		__global gsl_cdf_beta_aggregate *group = &partial[get_group_id(0)];
+		group->sum = sum;
+		group->weighted_sum = weighted_sum;
+		group->min = min;
+		group->max = max;
+		group->argmin = argmin;
+		group->argmax = argmax;
+		group->count = count;
+	}
+}
+
+__kernel void gsl_cdf_beta_P_reduce_cl(__global gsl_cdf_beta_request *request, __global gsl_cdf_beta_aggregate *partial, const ulong count, __global const double *weight, const int weighted, const double threshold)
+{
+	__local double scratch[OPENCL_REDUCE_GROUP];
+	__local long scratch_index[OPENCL_REDUCE_GROUP];
+	gsl_cdf_beta_aggregate own;
+
+	gsl_cdf_beta_aggregate_start(&own);
+	for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+		gsl_cdf_beta_aggregate_add(&own, gsl_cdf_beta_P(request[i].x, request[i].a, request[i].b), i, weighted ? weight[i] : 1.0, threshold);
+	}
+
+	gsl_cdf_beta_aggregate_group(&own, partial, scratch, scratch_index);
+}
+
+__kernel void gsl_cdf_beta_Q_reduce_cl(__global gsl_cdf_beta_request *request, __global gsl_cdf_beta_aggregate *partial, const ulong count, __global const double *weight, const int weighted, const double threshold)
+{
+	__local double scratch[OPENCL_REDUCE_GROUP];
+	__local long scratch_index[OPENCL_REDUCE_GROUP];
+	gsl_cdf_beta_aggregate own;
+
+	gsl_cdf_beta_aggregate_start(&own);
+	for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+		gsl_cdf_beta_aggregate_add(&own, gsl_cdf_beta_Q(request[i].x, request[i].a, request[i].b), i, weighted ? weight[i] : 1.0, threshold);
+	}
+
+	gsl_cdf_beta_aggregate_group(&own, partial, scratch, scratch_index);
+}
+
+/* A request whose result passed the filter: its index in the launch and its
+value.  Hits come out in no particular order. */
+struct gsl_cdf_beta_hit
+{
+	long index;
+	double value;
+};
+
+typedef struct gsl_cdf_beta_hit gsl_cdf_beta_hit;
+
+/* Q over a batch keeping only results above a threshold, threshold[i] when
+per_request is set and threshold[0] otherwise.  *hit_count must be zero on
+entry and holds the number of hits on exit. */
+__kernel void gsl_cdf_beta_Q_filter_cl(__global gsl_cdf_beta_request *request, __global gsl_cdf_beta_hit *hit, __global volatile uint *hit_count, const ulong count, __global const double *threshold, const int per_request)
+{
+	__local volatile uint scratch[2];
+	size_t i = get_global_id(0);
+	int live = i < count;
+	double value = live ? gsl_cdf_beta_Q(request[i].x, request[i].a, request[i].b) : 0.0;
+	int keep = live && value > threshold[per_request ? i : 0];
+	uint slot = compact_slot(keep, scratch, hit_count);
+
+	if (keep) {
+		hit[slot].index = i;
+		hit[slot].value = value;
+	}
+}
+
+/* The stages of a batch run as a graph (openClGraph, beta_regime_graph):
+classify, a regime launch per regime, scatter and aggregate.  Requests are
+split by the way gsl_cdf_beta_Q will go, so each launch's wavefronts stay
+on one path: outside (0, 1), the continued fraction taken directly, or
+taken on 1 - x.  member holds the request indices of regime r from
+r * capacity, counts[r] how many there are, and value the Q of member[s]
+at s.  counts must be zero before classify, and each regime launch is
+capacity work items, the ones past counts[r] doing nothing, so none of the
+launches needs anything from the host. */
+
+#define GSL_CDF_BETA_REGIME_EDGE 0
+#define GSL_CDF_BETA_REGIME_DIRECT 1
+#define GSL_CDF_BETA_REGIME_REFLECTED 2
+#define GSL_CDF_BETA_REGIME_COUNT 3
+
+int gsl_cdf_beta_regime(double x, double a, double b)
+{
+	if (x <= 0.0 || x >= 1.0) {
+		return GSL_CDF_BETA_REGIME_EDGE;
+	}
+	return x < (a + 1.0) / (a + b + 2.0) ? GSL_CDF_BETA_REGIME_DIRECT : GSL_CDF_BETA_REGIME_REFLECTED;
+}
+
+__kernel void gsl_cdf_beta_classify_cl(__global gsl_cdf_beta_request *request, __global uint *member, __global volatile uint *counts, const ulong count, const ulong capacity)
+{
+	__local volatile uint scratch[2];
+	size_t i = get_global_id(0);
+	int live = i < count;
+	int regime = live ? gsl_cdf_beta_regime(request[i].x, request[i].a, request[i].b) : -1;
+
+	for (int r = 0; r < GSL_CDF_BETA_REGIME_COUNT; r++) {
+		uint slot = compact_slot(regime == r, scratch, &counts[r]);
+		if (regime == r) {
+			member[r * capacity + slot] = (uint)i;
+		}
+	}
+}
+
+__kernel void gsl_cdf_beta_Q_regime_cl(__global gsl_cdf_beta_request *request, __global const uint *member, __global const uint *counts, __global double *value, const int regime, const ulong capacity)
+{
+	int threadId = get_global_id(0);
+
+	if (threadId < counts[regime]) {
+		size_t slot = regime * capacity + threadId;
+		uint i = member[slot];
+		value[slot] = gsl_cdf_beta_Q(request[i].x, request[i].a, request[i].b);
+	}
+}
+
+// one work item per slot of every regime, capacity * GSL_CDF_BETA_REGIME_COUNT
+__kernel void gsl_cdf_beta_scatter_cl(__global const uint *member, __global const uint *counts, __global const double *value, __global gsl_cdf_beta_response *response, const ulong capacity)
+{
+	size_t slot = get_global_id(0);
+	int regime = slot / capacity;
+
+	if (slot - regime * capacity < counts[regime]) {
+		uint i = member[slot];
+		response[i].threadid = i;
+		response[i].result = value[slot];
+	}
+}
+
+// the aggregate of results already on the device, as gsl_cdf_beta_Q_reduce_cl makes of the Q it computes
+__kernel void gsl_cdf_beta_aggregate_cl(__global const gsl_cdf_beta_response *response, __global gsl_cdf_beta_aggregate *partial, const ulong count, __global const double *weight, const int weighted, const double threshold)
+{
+	__local double scratch[OPENCL_REDUCE_GROUP];
+	__local long scratch_index[OPENCL_REDUCE_GROUP];
+	gsl_cdf_beta_aggregate own;
+
+	gsl_cdf_beta_aggregate_start(&own);
+	for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+		gsl_cdf_beta_aggregate_add(&own, response[i].result, i, weighted ? weight[i] : 1.0, threshold);
+	}
+
+	gsl_cdf_beta_aggregate_group(&own, partial, scratch, scratch_index);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <exception>
+
+#include "file_data.h"
+
+/* gslbeta.cl as it is handed to the OpenCL compiler.  The incomplete beta
+core and the special functions under it live in gslcore.h, shared with
+gslport.h, and gslbeta.cl only includes it; device compilers do not reliably
+search the working directory, so the include line is replaced with the text
+of gslcore.h here and the program is built from one self contained source.  Load it wherever gslbeta.cl would be
+loaded with io::file_data.
+
+Variants of the core (see gslcore.h) are picked with -D build options on the
+program built from it, as beta_specializer does for its literals. */
+
+class gsl_source
+{
+	std::string source;
+
+public:
+
+	gsl_source()
+	{
+		static const char *include_line = "#include \"gslcore.h\"";
+
+		io::file_data gsl("gslbeta.cl");
+		io::file_data core("gslcore.h");
+		if (gsl.get_error() || core.get_error()) {
+			throw std::exception("could not read gslbeta.cl or gslcore.h");
+		}
+
+		std::string text = gsl.get_data();
+		size_t at = text.find(include_line);
+		if (at == std::string::npos) {
+			throw std::exception("gslbeta.cl does not include gslcore.h");
+		}
+
+		source.reserve(text.size() + strlen(core.get_data()));
+		source.append(text, 0, at);
+		source.append(core.get_data());
+		source.append(text, at + strlen(include_line), std::string::npos);
+	}
+
+	const char *get_data() const
+	{
+		return source.c_str();
+	}
+};
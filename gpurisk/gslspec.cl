@@ -0,0 +1,23 @@
+/*
+ * I_x(a, b) for one (a, b) across a batch of x.  Build after gslbeta.cl.
+ *
+ * Built as it is, a, b and ln(B(a,b)) are kernel arguments.  Built with
+ * -DBETA_SPEC_A=, -DBETA_SPEC_B= and -DBETA_SPEC_LNBETA= they are literals
+ * instead: once gsl_cdf_beta_P_lnbeta is inlined, the tests on a and b alone
+ * fold away, regimes that cannot be reached for the pair are dropped and the
+ * continued fraction's a + b, a + 1 and friends become constants.  The
+ * arguments are still passed, and ignored, so both builds launch the same way.
+ */
+
+__kernel void gsl_cdf_beta_spec_cl(__global double *x, __global double *value, double a, double b, double ln_beta, int upper)
+{
+	int threadId = get_global_id(0);
+
+#ifdef BETA_SPEC_A
+	a = BETA_SPEC_A;
+	b = BETA_SPEC_B;
+	ln_beta = BETA_SPEC_LNBETA;
+#endif
+
+	value[threadId] = upper ? gsl_cdf_beta_Q_lnbeta(x[threadId], a, b, ln_beta) : gsl_cdf_beta_P_lnbeta(x[threadId], a, b, ln_beta);
+}
@@ -0,0 +1,63 @@
+/*
+ * Batch entry points for the special functions gslbeta.cl ports for the
+ * incomplete beta and gamma.  Build after gslbeta.cl.  Arguments and values
+ * are plain arrays of double, one element per work item, so a batch uploads
+ * only the arguments it has and coalesces on every read and write.  Values
+ * are what the _e functions write, NaN outside the domain.
+ */
+
+__kernel void gsl_sf_psi_cl(__global const double *x, __global double *value)
+{
+	int threadId = get_global_id(0);
+	gsl_sf_result result;
+
+	gsl_sf_psi_e(x[threadId], &result);
+	value[threadId] = result.val;
+}
+
+__kernel void gsl_sf_psi_1_cl(__global const double *x, __global double *value)
+{
+	int threadId = get_global_id(0);
+	gsl_sf_result result;
+
+	gsl_sf_psi_1_e(x[threadId], &result);
+	value[threadId] = result.val;
+}
+
+__kernel void gsl_sf_erfc_cl(__global const double *x, __global double *value)
+{
+	int threadId = get_global_id(0);
+	gsl_sf_result result;
+
+	gsl_sf_erfc_e(x[threadId], &result);
+	value[threadId] = result.val;
+}
+
+__kernel void gsl_sf_lngamma_cl(__global const double *x, __global double *value)
+{
+	int threadId = get_global_id(0);
+	gsl_sf_result result;
+
+	gsl_sf_lngamma_e(x[threadId], &result);
+	value[threadId] = result.val;
+}
+
+/* psi^(n)(x), the order per element */
+__kernel void gsl_sf_psi_n_cl(__global const double *x, __global double *value, __global const int *order)
+{
+	int threadId = get_global_id(0);
+	gsl_sf_result result;
+
+	gsl_sf_psi_n_e(order[threadId], x[threadId], &result);
+	value[threadId] = result.val;
+}
+
+/* zeta(s, q) */
+__kernel void gsl_sf_hzeta_cl(__global const double *s, __global double *value, __global const double *q)
+{
+	int threadId = get_global_id(0);
+	gsl_sf_result result;
+
+	gsl_sf_hzeta_e(s[threadId], q[threadId], &result);
+	value[threadId] = result.val;
+}
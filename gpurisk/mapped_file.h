@@ -0,0 +1,138 @@
+#pragma once
+
+#include "windows.h"
+#include <string>
+#include <exception>
+
+#if LINUX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace io
+{
+	/* A read/write memory mapping of a file of a fixed size.  The file is
+	created (zero filled) when it does not exist, and grown to the requested
+	size when it is shorter.  created() tells the caller whether the contents
+	are fresh so it can lay down a header. */
+
+	class mapped_file
+	{
+		std::string file_name;
+		size_t length;
+		bool fresh;
+		void *view;
+
+#if LINUX
+		int fd;
+#else
+		HANDLE hFile;
+		HANDLE hMapping;
+#endif
+
+	public:
+
+		mapped_file(const char *cfilename, size_t _length) : file_name(cfilename), length(_length), fresh(false), view(nullptr)
+		{
+#if LINUX
+			struct stat stat_buf;
+			fresh = stat(cfilename, &stat_buf) != 0 || (size_t)stat_buf.st_size < length;
+
+			fd = open(cfilename, O_RDWR | O_CREAT, 0644);
+			if (fd < 0) {
+				throw std::exception("Couldn't open mapped file.");
+			}
+
+			if (fresh && ftruncate(fd, length) != 0) {
+				close(fd);
+				throw std::exception("Couldn't size mapped file.");
+			}
+
+			view = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (view == MAP_FAILED) {
+				close(fd);
+				throw std::exception("Couldn't map file.");
+			}
+#else
+			hFile = CreateFileA(cfilename, // file to open
+				GENERIC_READ | GENERIC_WRITE, // open for reading and writing
+				FILE_SHARE_READ, // share for reading
+				NULL, // default security
+				OPEN_ALWAYS, // create it if it is not there
+				FILE_ATTRIBUTE_NORMAL,// normal file
+				NULL); // no attribute template
+			if (hFile == INVALID_HANDLE_VALUE) {
+				throw std::exception("Couldn't open mapped file.");
+			}
+
+			LARGE_INTEGER existing;
+			GetFileSizeEx(hFile, &existing);
+			fresh = (size_t)existing.QuadPart < length;
+
+			LARGE_INTEGER size;
+			size.QuadPart = length;
+			hMapping = CreateFileMappingA(hFile, NULL, PAGE_READWRITE, size.HighPart, size.LowPart, NULL);
+			if (hMapping == NULL) {
+				CloseHandle(hFile);
+				throw std::exception("Couldn't create file mapping.");
+			}
+
+			view = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, length);
+			if (view == nullptr) {
+				CloseHandle(hMapping);
+				CloseHandle(hFile);
+				throw std::exception("Couldn't map file.");
+			}
+#endif
+		}
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator = (const mapped_file&) = delete;
+
+		virtual ~mapped_file()
+		{
+#if LINUX
+			munmap(view, length);
+			close(fd);
+#else
+			UnmapViewOfFile(view);
+			CloseHandle(hMapping);
+			CloseHandle(hFile);
+#endif
+		}
+
+		// flushes dirty pages back to the file
+		void flush()
+		{
+#if LINUX
+			msync(view, length, MS_SYNC);
+#else
+			FlushViewOfFile(view, length);
+			FlushFileBuffers(hFile);
+#endif
+		}
+
+		void *get_data()
+		{
+			return view;
+		}
+
+		size_t get_data_length() const
+		{
+			return length;
+		}
+
+		bool created() const
+		{
+			return fresh;
+		}
+
+		const std::string& get_file_name()
+		{
+			return file_name;
+		}
+	};
+
+}
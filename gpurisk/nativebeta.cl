@@ -29,10 +29,25 @@
 #define TINY 1.0e-30
 #define ERR_VALUE 0;
 
-double incbetaimpl(double x, double a, double b) {
+/* incbetaimpl with lbeta_ab = ln(B(a,b)) supplied, so a table built once per
+batch saves the three lgamma calls.  B is symmetric, so the swap below keeps it.
+stop is the Lentz convergence test, STOP in the stock kernels.
+
+*err is set to an estimate of the absolute error: the continued fraction tail,
+taken as geometric at the rate the last two steps contracted, rounding in the
+prefactor, whose exponent and lbeta_ab (error lbeta_err) can be large and
+cancel, and INFINITY when the fraction did not converge or x is out of range. */
+double incbetaimpl_err(double x, double a, double b, const double lbeta_ab, const double lbeta_err, const double stop, double *err) {
 	bool invert = false;
+    *err = INFINITY;
     if (x < 0.0 || x > 1.0) return ERR_VALUE;
 
+    /*The end points are exact; past here log(x) or log(1-x) would make the error estimate NaN.*/
+    if (x == 0.0 || x == 1.0) {
+        *err = 0.0;
+        return x;
+    }
+
     /*The continued fraction converges nicely for x < (a+1)/(a+b+2), SO Use the fact that beta is symmetrical.*/
     if (x > (a+1.0)/(a+b+2.0)) {
 		double t = a;
@@ -43,11 +58,12 @@ double incbetaimpl(double x, double a, double b) {
     }
 
     /*Find the first part before the continued fraction.*/
-    const double lbeta_ab = lgamma(a)+lgamma(b)-lgamma(a+b);
+    const double exponent_size = fabs(log(x)*a)+fabs(log(1.0-x)*b)+a+b;
     const double front = exp(log(x)*a+log(1.0-x)*b-lbeta_ab) / a;
 
     /*Use Lentz's algorithm to evaluate the continued fraction.*/
     double f = 1.0, c = 1.0, d = 0.0;
+    double step1 = 1.0, step2 = 1.0;
 
     int i, m;
     for (i = 0; i <= 200; ++i) {
@@ -74,18 +90,38 @@ double incbetaimpl(double x, double a, double b) {
         f *= cd;
 
         /*Check for stop.*/
-        if (fabs(1.0-cd) < STOP) {
+        const double step = fabs(1.0-cd);
+        if (step < stop) {
 			double v = front * (f - 1.0);
+			/*A zero numerator (integer b) ends the fraction exactly, otherwise odd and even steps can differ a lot, so take the larger.*/
+			const double rate = fmin(sqrt(fmax(step, step1)/fmax(fmax(step2, step1), TINY)), 0.999);
+			const double tail = numerator == 0.0 ? 0.0 : 2.0*fmax(step, step1)/(1.0-rate);
+			*err = fabs(v) * (tail + lbeta_err + 4.0*DBL_EPSILON*(exponent_size + i)) + DBL_EPSILON;
 			if (invert) {
 				v = 1.0 - v;
 			}
             return v;
         }
+        step2 = step1;
+        step1 = step;
     }
 
     return ERR_VALUE; /*Needed more loops, did not converge.*/
 }
 
+double incbetaimpl_tol(double x, double a, double b, const double lbeta_ab, const double stop) {
+    double err;
+    return incbetaimpl_err(x, a, b, lbeta_ab, 0.0, stop, &err);
+}
+
+double incbetaimpl_lnbeta(double x, double a, double b, const double lbeta_ab) {
+    return incbetaimpl_tol(x, a, b, lbeta_ab, STOP);
+}
+
+double incbetaimpl(double x, double a, double b) {
+    return incbetaimpl_lnbeta(x, a, b, lgamma(a)+lgamma(b)-lgamma(a+b));
+}
+
 struct beta_request
 {
 	double x, a, b;
@@ -116,3 +152,98 @@ __kernel void incBetaQ(__global beta_request *request, __global beta_response *r
 	response[threadId].result = 1.0-incbetaimpl(request[threadId].x, request[threadId].a, request[threadId].b);
 }
 
+/* The standard precision tier: STOP given per batch.  The iteration cap stays
+at 200, so a tolerance much under 1e-12 only helps when a and b are modest. */
+__kernel void incBetaQTol(__global beta_request *request, __global beta_response *response, const double tol)
+{
+	int threadId = get_global_id(0);
+	double a = request[threadId].a, b = request[threadId].b;
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = 1.0-incbetaimpl_tol(request[threadId].x, a, b, lgamma(a)+lgamma(b)-lgamma(a+b), tol);
+}
+
+struct beta_estimate
+{
+	int threadid;
+	double result;
+	double err;
+};
+
+typedef struct beta_estimate beta_estimate;
+
+/* The first pass of a refined batch: Q with its error estimate, so the host
+can send only the requests over its tolerance to the exact kernel. */
+__kernel void incBetaQEstimate(__global beta_request *request, __global beta_estimate *response, const double stop)
+{
+	int threadId = get_global_id(0);
+	double a = request[threadId].a, b = request[threadId].b;
+	double lga = lgamma(a), lgb = lgamma(b), lgab = lgamma(a+b);
+	double err;
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = 1.0-incbetaimpl_err(request[threadId].x, a, b, lga+lgb-lgab, 2.0*DBL_EPSILON*(fabs(lga)+fabs(lgb)+fabs(lgab)), stop, &err);
+	response[threadId].err = err;
+}
+
+struct beta_param
+{
+	double a, b, lnbeta;
+};
+
+typedef struct beta_param beta_param;
+
+struct beta_param_request
+{
+	double x;
+	int param;
+};
+
+typedef struct beta_param_request beta_param_request;
+
+__kernel void incBetaParam(__global beta_param_request *request, __global beta_response *response, __global const beta_param *params)
+{
+	int threadId = get_global_id(0);
+	__global const beta_param *param = &params[request[threadId].param];
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = incbetaimpl_lnbeta(request[threadId].x, param->a, param->b, param->lnbeta);
+}
+
+__kernel void incBetaQParam(__global beta_param_request *request, __global beta_response *response, __global const beta_param *params)
+{
+	int threadId = get_global_id(0);
+	__global const beta_param *param = &params[request[threadId].param];
+
+	response[threadId].threadid = threadId;
+	response[threadId].result = 1.0-incbetaimpl_lnbeta(request[threadId].x, param->a, param->b, param->lnbeta);
+}
+
+/* A grid of requests described rather than materialized: x runs from x_start
+in x_count steps of x_step along dimension 0.  Dimension 1 indexes the
+(a_values[j], b_values[j]) pairs, or for the product kernels a_values, with
+b_values along dimension 2.  Results are laid out x fastest. */
+struct beta_grid
+{
+	double x_start, x_step;
+	int x_count;
+	int a_count;
+};
+
+typedef struct beta_grid beta_grid;
+
+__kernel void incBetaQTolPairs(__global beta_grid *grid, __global double *result, __global const double *a_values, __global const double *b_values, const double tol)
+{
+	size_t i = get_global_id(0), j = get_global_id(1);
+	double x = grid->x_start + i * grid->x_step, a = a_values[j], b = b_values[j];
+
+	result[i + grid->x_count * j] = 1.0-incbetaimpl_tol(x, a, b, lgamma(a)+lgamma(b)-lgamma(a+b), tol);
+}
+
+__kernel void incBetaQTolProduct(__global beta_grid *grid, __global double *result, __global const double *a_values, __global const double *b_values, const double tol)
+{
+	size_t i = get_global_id(0), j = get_global_id(1), k = get_global_id(2);
+	double x = grid->x_start + i * grid->x_step, a = a_values[j], b = b_values[k];
+
+	result[i + grid->x_count * (j + grid->a_count * k)] = 1.0-incbetaimpl_tol(x, a, b, lgamma(a)+lgamma(b)-lgamma(a+b), tol);
+}
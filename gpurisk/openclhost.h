@@ -1,88 +1,1288 @@
 #pragma once
 
 #include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #include "file_data.h"
 
 #include <CL/cl.h>
 
+/* Kernel arguments after the input and output buffers.  Arrays are wrapped
+with openClIn (uploaded, read only) or openClOut (uploaded, then read back
+after the kernel runs); anything else is passed to the kernel by value. */
+
+template <class T> struct openClInput
+{
+	const T *data;
+	size_t count;
+};
+
+template <class T> struct openClOutput
+{
+	T *data;
+	size_t count;
+};
+
+template <class T> openClInput<T> openClIn(const T *data, size_t count)
+{
+	openClInput<T> arg = { data, count };
+	return arg;
+}
+
+template <class T> openClOutput<T> openClOut(T *data, size_t count)
+{
+	openClOutput<T> arg = { data, count };
+	return arg;
+}
+
+/* Arrays with one element per request, for RunKernel, which may cut a batch
+into chunks: each chunk gets only its slice, while arrays passed with
+openClIn and openClOut are whole on the device for every chunk.  Kernels
+see indices within their chunk; one that needs the request's index in the
+batch takes an openClFirst, a ulong holding the chunk's first request. */
+
+template <class T> struct openClInputEach
+{
+	const T *data;
+};
+
+template <class T> struct openClOutputEach
+{
+	T *data;
+};
+
+struct openClFirstIndex
+{
+	;
+};
+
+template <class T> openClInputEach<T> openClInEach(const T *data)
+{
+	openClInputEach<T> arg = { data };
+	return arg;
+}
+
+template <class T> openClOutputEach<T> openClOutEach(T *data)
+{
+	openClOutputEach<T> arg = { data };
+	return arg;
+}
+
+inline openClFirstIndex openClFirst()
+{
+	openClFirstIndex arg;
+	return arg;
+}
+
+/* Work group reductions for kernels that hand back per group partials
+instead of a result per work item, and compaction for kernels that hand
+back only some of their results.  Build it ahead of the kernels with the
+multiple source openClProgram constructor and launch them with RunReduce
+or RunCompact, which use work groups of openClReduceGroup or, where the
+device takes less for the kernel, the largest power of 2 below it.  Every
+work item of a group must make the same calls, so items past the end of the
+input take part with an identity value.  Ties in min and max go to the lower
+index; index -1, used for items with nothing to offer, loses every tie.
+
+A reduction runs at most openClReduceGroupsPerUnit groups on each compute
+unit, whatever the input size: each work item folds the inputs from its
+global id on in steps of the global size before the group reduces, so the
+partials read back stay a few kilobytes. */
+
+const size_t openClReduceGroup = 256;
+const size_t openClReduceGroupsPerUnit = 8;
+
+const char * const openClReduceSource = R"OPENCLREDUCE(
+
+#define OPENCL_REDUCE_GROUP 256
+
+double reduce_sum(double value, __local double *scratch)
+{
+	int lid = get_local_id(0);
+	int s;
+	double total;
+
+	scratch[lid] = value;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for (s = get_local_size(0) / 2; s > 0; s >>= 1) {
+		if (lid < s) {
+			scratch[lid] += scratch[lid + s];
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+	}
+	total = scratch[0];
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return total;
+}
+
+// the total of every item's count
+long reduce_count(long count, __local long *scratch)
+{
+	int lid = get_local_id(0);
+	int s;
+	long total;
+
+	scratch[lid] = count;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for (s = get_local_size(0) / 2; s > 0; s >>= 1) {
+		if (lid < s) {
+			scratch[lid] += scratch[lid + s];
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+	}
+	total = scratch[0];
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return total;
+}
+
+/* sign is 1 for min and -1 for max, the winner's index goes to *arg */
+double reduce_best(double value, long index, double sign, __local double *scratch, __local long *scratch_index, long *arg)
+{
+	int lid = get_local_id(0);
+	int s;
+	double best;
+
+	scratch[lid] = sign * value;
+	scratch_index[lid] = index;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	for (s = get_local_size(0) / 2; s > 0; s >>= 1) {
+		if (lid < s) {
+			double other = scratch[lid + s];
+			long other_index = scratch_index[lid + s];
+			if (other < scratch[lid] || (other == scratch[lid] && (ulong)other_index < (ulong)scratch_index[lid])) {
+				scratch[lid] = other;
+				scratch_index[lid] = other_index;
+			}
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+	}
+	best = sign * scratch[0];
+	*arg = scratch_index[0];
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return best;
+}
+
+double reduce_min(double value, long index, __local double *scratch, __local long *scratch_index, long *arg)
+{
+	return reduce_best(value, index, 1.0, scratch, scratch_index, arg);
+}
+
+double reduce_max(double value, long index, __local double *scratch, __local long *scratch_index, long *arg)
+{
+	return reduce_best(value, index, -1.0, scratch, scratch_index, arg);
+}
+
+/* Stream compaction: every work item calls it, those with keep set get a
+distinct slot in the output.  A group counts its hits in local memory and
+reserves room for all of them with one atomic on *total, so slots are dense
+but their order across and within groups is not fixed.  scratch needs two
+uints. */
+uint compact_slot(int keep, __local volatile uint *scratch, __global volatile uint *total)
+{
+	uint slot = 0;
+
+	if (get_local_id(0) == 0) {
+		scratch[0] = 0;
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (keep) {
+		slot = atomic_inc(&scratch[0]);
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (get_local_id(0) == 0) {
+		scratch[1] = scratch[0] ? atomic_add(total, scratch[0]) : 0;
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	return scratch[1] + slot;
+}
+
+)OPENCLREDUCE";
+
+/* An array kept on the device between launches.  It is made by an
+openClProgram, with Upload or Allocate, and passed to that program's
+launches where an array argument goes; nothing moves between host and
+device until Download.  A launch can write one and a later launch read it,
+so a chain of kernels over one batch uploads the batch once and downloads
+only its final results.  A dataset belongs to the context of the program
+that made it and must go before the program does; a launch of any other
+program given it throws.  RunResident returns before its launch has run,
+so the program's other launches, which go on queues of their own, and a
+graph's Run first wait for the resident queue when they are given datasets. */
+
+template <class T> class openClDataset
+{
+	static_assert(std::is_pod<T>::value, "openClDataset elements must be plain old data.");
+
+	template <class INPUT, class OUTPUT> friend class openClProgram;
+	template <class INPUT, class OUTPUT> friend class openClGraph;
+
+	cl_mem buffer;
+	size_t count;
+	cl_context context;
+
+	openClDataset(cl_mem _buffer, size_t _count, cl_context _context) : buffer(_buffer), count(_count), context(_context)
+	{
+		;
+	}
+
+public:
+
+	openClDataset() : buffer(NULL), count(0), context(NULL)
+	{
+		;
+	}
+
+	openClDataset(openClDataset&& _src) : buffer(_src.buffer), count(_src.count), context(_src.context)
+	{
+		_src.buffer = NULL;
+		_src.count = 0;
+		_src.context = NULL;
+	}
+
+	openClDataset& operator = (openClDataset&& _src)
+	{
+		std::swap(buffer, _src.buffer);
+		std::swap(count, _src.count);
+		std::swap(context, _src.context);
+		return *this;
+	}
+
+	openClDataset(const openClDataset&) = delete;
+	openClDataset& operator = (const openClDataset&) = delete;
+
+	virtual ~openClDataset()
+	{
+		if (buffer) {
+			clReleaseMemObject(buffer);
+		}
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+};
+
 template <class INPUT, class OUTPUT> class openClProgram 
 {
 
 	static_assert(std::is_pod<INPUT>::value, "INPUT must be plain old data - no pointers, no dynamic elements, everything public, a struct.");
 	static_assert(std::is_pod<OUTPUT>::value, "OUTPUT must be plain old data - no pointers, no dynamic elements, everything public, a struct.");
 
-	cl_platform_id platform;
-	cl_device_id device;
-	cl_context context;
-	cl_program program;
+	cl_platform_id platform;
+	cl_device_id device;
+	cl_context context;
+	cl_program program;
+
+	// device limits, 0 when the device would not say
+	cl_ulong max_alloc;
+	cl_ulong global_mem;
+	cl_uint compute_units;
+
+	size_t chunk_limit;
+	size_t last_chunk;
+
+	// RunResident launches go in order on one queue, with kernels made once per name
+	cl_command_queue resident_queue;
+	std::map<std::string, cl_kernel> resident_kernels;
+
+	template <class GRAPH_INPUT, class GRAPH_OUTPUT> friend class openClGraph;
+
+	struct openClBinding
+	{
+		cl_mem buffer;
+		void *readback;
+		size_t size;
+	};
+
+	void releaseBindings(std::vector<openClBinding>& bindings)
+	{
+		for (auto& binding : bindings)
+		{
+			clReleaseMemObject(binding.buffer);
+		}
+		bindings.clear();
+	}
+
+	/* Whether any of args is a dataset, throwing for one made by another
+	program, whose buffer means nothing in this context. */
+	bool checkDatasets()
+	{
+		return false;
+	}
+
+	template <class T, class... Args> bool checkDatasets(const openClDataset<T>& arg, const Args&... args)
+	{
+		if (arg.context != context) {
+			throw std::exception("A dataset can only be passed to launches of the program that made it.");
+		}
+		checkDatasets(args...);
+		return true;
+	}
+
+	template <class T, class... Args> bool checkDatasets(const T& arg, const Args&... args)
+	{
+		return checkDatasets(args...);
+	}
+
+	// RunResident launches still queued are finished, so the datasets they write are whole
+	void finishResident()
+	{
+		if (resident_queue) {
+			clFinish(resident_queue);
+		}
+	}
+
+	// for launches on queues other than the resident one
+	template <class... Args> void waitForDatasets(const Args&... args)
+	{
+		if (checkDatasets(args...)) {
+			finishResident();
+		}
+	}
+
+	void bindArgs(cl_kernel kernel, cl_uint index, std::vector<openClBinding>& bindings)
+	{
+		;
+	}
+
+	template <class T, class... Args> void bindArgs(cl_kernel kernel, cl_uint index, std::vector<openClBinding>& bindings, const openClInput<T>& arg, const Args&... args)
+	{
+		int err;
+		auto buffer = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, sizeof(T) * arg.count, (void *)arg.data, &err);
+		if (err < 0) {
+			throw std::exception("Couldn't create argument buffer.");
+		}
+		openClBinding binding = { buffer, nullptr, 0 };
+		bindings.push_back(binding);
+
+		err = clSetKernelArg(kernel, index, sizeof(cl_mem), &buffer);
+		if (err < 0) {
+			throw std::exception("Couldn't create kernel argument.");
+		}
+		bindArgs(kernel, index + 1, bindings, args...);
+	}
+
+	template <class T, class... Args> void bindArgs(cl_kernel kernel, cl_uint index, std::vector<openClBinding>& bindings, const openClOutput<T>& arg, const Args&... args)
+	{
+		int err;
+		auto buffer = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(T) * arg.count, arg.data, &err);
+		if (err < 0) {
+			throw std::exception("Couldn't create argument buffer.");
+		}
+		openClBinding binding = { buffer, arg.data, sizeof(T) * arg.count };
+		bindings.push_back(binding);
+
+		err = clSetKernelArg(kernel, index, sizeof(cl_mem), &buffer);
+		if (err < 0) {
+			throw std::exception("Couldn't create kernel argument.");
+		}
+		bindArgs(kernel, index + 1, bindings, args...);
+	}
+
+	template <class T, class... Args> void bindArgs(cl_kernel kernel, cl_uint index, std::vector<openClBinding>& bindings, const T& arg, const Args&... args)
+	{
+		static_assert(std::is_pod<T>::value, "Kernel arguments passed by value must be plain old data.");
+
+		int err = clSetKernelArg(kernel, index, sizeof(T), &arg);
+		if (err < 0) {
+			throw std::exception("Couldn't create kernel argument.");
+		}
+		bindArgs(kernel, index + 1, bindings, args...);
+	}
+
+	// a dataset is already on the device, only its buffer is passed
+	template <class T, class... Args> void bindArgs(cl_kernel kernel, cl_uint index, std::vector<openClBinding>& bindings, const openClDataset<T>& arg, const Args&... args)
+	{
+		int err = clSetKernelArg(kernel, index, sizeof(cl_mem), &arg.buffer);
+		if (err < 0) {
+			throw std::exception("Couldn't create kernel argument.");
+		}
+		bindArgs(kernel, index + 1, bindings, args...);
+	}
+
+	template <class T, class... Args> void bindArgs(cl_kernel kernel, cl_uint index, std::vector<openClBinding>& bindings, const openClInputEach<T>& arg, const Args&... args)
+	{
+		static_assert(sizeof(T) == 0, "Per request arrays are only cut into chunks by RunKernel.");
+	}
+
+	template <class T, class... Args> void bindArgs(cl_kernel kernel, cl_uint index, std::vector<openClBinding>& bindings, const openClOutputEach<T>& arg, const Args&... args)
+	{
+		static_assert(sizeof(T) == 0, "Per request arrays are only cut into chunks by RunKernel.");
+	}
+
+	template <class... Args> void bindArgs(cl_kernel kernel, cl_uint index, std::vector<openClBinding>& bindings, const openClFirstIndex& arg, const Args&... args)
+	{
+		static_assert(sizeof...(Args) != sizeof...(Args), "Only RunKernel launches in chunks.");
+	}
+
+	/* An array argument of a chunked launch.  size is the bytes of the whole
+	array, or for a per request array the bytes of one element. */
+	struct openClChunkArg
+	{
+		cl_uint index;
+		cl_mem buffer;
+		char *data;
+		size_t size;
+		bool each;
+		bool out;
+		bool first;
+	};
+
+	int describeArgs(cl_kernel kernel, cl_uint index, std::vector<openClChunkArg>& chunk_args)
+	{
+		return CL_SUCCESS;
+	}
+
+	template <class T, class... Args> int describeArgs(cl_kernel kernel, cl_uint index, std::vector<openClChunkArg>& chunk_args, const openClInput<T>& arg, const Args&... args)
+	{
+		openClChunkArg chunk_arg = { index, NULL, (char *)arg.data, sizeof(T) * arg.count, false, false, false };
+		chunk_args.push_back(chunk_arg);
+		return describeArgs(kernel, index + 1, chunk_args, args...);
+	}
+
+	template <class T, class... Args> int describeArgs(cl_kernel kernel, cl_uint index, std::vector<openClChunkArg>& chunk_args, const openClOutput<T>& arg, const Args&... args)
+	{
+		openClChunkArg chunk_arg = { index, NULL, (char *)arg.data, sizeof(T) * arg.count, false, true, false };
+		chunk_args.push_back(chunk_arg);
+		return describeArgs(kernel, index + 1, chunk_args, args...);
+	}
+
+	template <class T, class... Args> int describeArgs(cl_kernel kernel, cl_uint index, std::vector<openClChunkArg>& chunk_args, const openClInputEach<T>& arg, const Args&... args)
+	{
+		openClChunkArg chunk_arg = { index, NULL, (char *)arg.data, sizeof(T), true, false, false };
+		chunk_args.push_back(chunk_arg);
+		return describeArgs(kernel, index + 1, chunk_args, args...);
+	}
+
+	template <class T, class... Args> int describeArgs(cl_kernel kernel, cl_uint index, std::vector<openClChunkArg>& chunk_args, const openClOutputEach<T>& arg, const Args&... args)
+	{
+		openClChunkArg chunk_arg = { index, NULL, (char *)arg.data, sizeof(T), true, true, false };
+		chunk_args.push_back(chunk_arg);
+		return describeArgs(kernel, index + 1, chunk_args, args...);
+	}
+
+	// a dataset is whole on the device for every chunk and costs no transfer
+	template <class T, class... Args> int describeArgs(cl_kernel kernel, cl_uint index, std::vector<openClChunkArg>& chunk_args, const openClDataset<T>& arg, const Args&... args)
+	{
+		int err = clSetKernelArg(kernel, index, sizeof(cl_mem), &arg.buffer);
+		if (err < 0) {
+			return err;
+		}
+		return describeArgs(kernel, index + 1, chunk_args, args...);
+	}
+
+	template <class... Args> int describeArgs(cl_kernel kernel, cl_uint index, std::vector<openClChunkArg>& chunk_args, const openClFirstIndex& arg, const Args&... args)
+	{
+		openClChunkArg chunk_arg = { index, NULL, NULL, 0, false, false, true };
+		chunk_args.push_back(chunk_arg);
+		return describeArgs(kernel, index + 1, chunk_args, args...);
+	}
+
+	// values are the same for every chunk and are set once
+	template <class T, class... Args> int describeArgs(cl_kernel kernel, cl_uint index, std::vector<openClChunkArg>& chunk_args, const T& arg, const Args&... args)
+	{
+		static_assert(std::is_pod<T>::value, "Kernel arguments passed by value must be plain old data.");
+
+		int err = clSetKernelArg(kernel, index, sizeof(T), &arg);
+		if (err < 0) {
+			return err;
+		}
+		return describeArgs(kernel, index + 1, chunk_args, args...);
+	}
+
+	/* The most requests a chunk can hold: no buffer over the device's largest
+	allocation, all of them within half its global memory, the rest left to
+	other programs, and never more work items than an int get_global_id(0)
+	can index. */
+	size_t chunkSize(size_t input_bytes, size_t output_bytes, const std::vector<openClChunkArg>& chunk_args, size_t input_size, size_t local_size) const
+	{
+		size_t largest = std::max(input_bytes, output_bytes);
+		size_t per_request = input_bytes + output_bytes;
+		size_t whole = 0;
+
+		for (auto& chunk_arg : chunk_args)
+		{
+			if (chunk_arg.each) {
+				largest = std::max(largest, chunk_arg.size);
+				per_request += chunk_arg.size;
+			}
+			else {
+				whole += chunk_arg.size;
+			}
+		}
+
+		size_t chunk = std::min(input_size, (size_t)INT_MAX / std::max<size_t>(local_size, 1));
+		if (max_alloc) {
+			chunk = std::min(chunk, (size_t)std::min<cl_ulong>(max_alloc / largest, SIZE_MAX));
+		}
+		if (global_mem) {
+			cl_ulong budget = global_mem / 2;
+			chunk = std::min(chunk, budget > whole ? (size_t)std::min<cl_ulong>((budget - whole) / per_request, SIZE_MAX) : 0);
+		}
+		if (chunk_limit) {
+			chunk = std::min(chunk, chunk_limit);
+		}
+		return std::max<size_t>(chunk, 1);
+	}
+
+	/* Why the arrays passed whole cannot go up at any chunk size, or null when
+	they fit: each needs a buffer of its own no larger than the device's largest
+	allocation, and together they must leave global memory for a request. */
+	const char *wholeArgsMisfit(const std::vector<openClChunkArg>& chunk_args) const
+	{
+		cl_ulong whole = 0;
+		for (auto& chunk_arg : chunk_args)
+		{
+			if (!chunk_arg.each) {
+				if (max_alloc && chunk_arg.size > max_alloc) {
+					return "An array passed whole is larger than the device's largest allocation.";
+				}
+				whole += chunk_arg.size;
+			}
+		}
+		if (global_mem && whole >= global_mem) {
+			return "The arrays passed whole are larger than the device's global memory.";
+		}
+		return NULL;
+	}
+
+	// responses carrying a threadid are numbered from the start of the batch, not of their chunk
+	template <class OutputStruct> static auto offsetThreadIds(OutputStruct *output, size_t n, size_t first, int) -> decltype((void)output->threadid)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			output[i].threadid += (int)first;
+		}
+	}
+
+	template <class OutputStruct> static void offsetThreadIds(OutputStruct *output, size_t n, size_t first, long)
+	{
+		;
+	}
+
+	void releaseChunkArgs(std::vector<openClChunkArg>& chunk_args)
+	{
+		for (auto& chunk_arg : chunk_args)
+		{
+			if (chunk_arg.buffer) {
+				clReleaseMemObject(chunk_arg.buffer);
+				chunk_arg.buffer = NULL;
+			}
+		}
+	}
+
+	/* Runs requests [*done, input_size) in chunks of chunk requests through one
+	set of buffers, advancing *done past each chunk read back.  Whole arrays are
+	uploaded once and read back after the last chunk.  A kernel numbers its
+	responses by get_global_id(0) within the chunk, so a threadid read back is
+	moved up by the chunk's first request.  Returns the first
+	OpenCL error with *stage saying what failed, having released the buffers. */
+	template <class InputStruct, class OutputStruct> int runChunks(cl_command_queue queue, cl_kernel kernel, InputStruct *input, OutputStruct *output, size_t input_size, size_t local_size,
+		size_t chunk, std::vector<openClChunkArg>& chunk_args, size_t *done, const char **stage)
+	{
+		cl_mem input_buffer = NULL, output_buffer = NULL;
+		int err = CL_SUCCESS;
+
+		*stage = "Couldn't input buffer.";
+		input_buffer = clCreateBuffer(context, CL_MEM_READ_ONLY, sizeof(InputStruct) * chunk, NULL, &err);
+		if (err >= 0) {
+			*stage = "Couldn't create output buffer.";
+			output_buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(OutputStruct) * chunk, NULL, &err);
+		}
+
+		*stage = "Couldn't create argument buffer.";
+		for (auto& chunk_arg : chunk_args)
+		{
+			if (err >= 0 && !chunk_arg.first) {
+				cl_mem_flags flags = chunk_arg.out ? CL_MEM_READ_WRITE : CL_MEM_READ_ONLY;
+				if (chunk_arg.each) {
+					chunk_arg.buffer = clCreateBuffer(context, flags, chunk_arg.size * chunk, NULL, &err);
+				}
+				else {
+					chunk_arg.buffer = clCreateBuffer(context, flags | CL_MEM_COPY_HOST_PTR, chunk_arg.size, chunk_arg.data, &err);
+				}
+			}
+		}
+
+		if (err >= 0) {
+			*stage = "Couldn't create kernel argument.";
+			err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &input_buffer);
+			if (err >= 0) {
+				err = clSetKernelArg(kernel, 1, sizeof(cl_mem), &output_buffer);
+			}
+			for (auto& chunk_arg : chunk_args)
+			{
+				if (err >= 0 && !chunk_arg.first) {
+					err = clSetKernelArg(kernel, chunk_arg.index, sizeof(cl_mem), &chunk_arg.buffer);
+				}
+			}
+		}
+
+		for (size_t first = *done; err >= 0 && first < input_size; first += chunk)
+		{
+			size_t n = std::min(chunk, input_size - first);
+			size_t work_size = n * local_size;
+
+			// outputs go up as well, as RunKernel has always uploaded them, for kernels that read them
+			*stage = "Couldn't write buffer.";
+			err = clEnqueueWriteBuffer(queue, input_buffer, CL_FALSE, 0, sizeof(InputStruct) * n, input + first, 0, NULL, NULL);
+			if (err >= 0) {
+				err = clEnqueueWriteBuffer(queue, output_buffer, CL_FALSE, 0, sizeof(OutputStruct) * n, output + first, 0, NULL, NULL);
+			}
+			for (auto& chunk_arg : chunk_args)
+			{
+				if (err >= 0 && chunk_arg.each) {
+					err = clEnqueueWriteBuffer(queue, chunk_arg.buffer, CL_FALSE, 0, chunk_arg.size * n, chunk_arg.data + chunk_arg.size * first, 0, NULL, NULL);
+				}
+				else if (err >= 0 && chunk_arg.first) {
+					cl_ulong first_index = first;
+					err = clSetKernelArg(kernel, chunk_arg.index, sizeof(cl_ulong), &first_index);
+				}
+			}
+
+			if (err >= 0) {
+				*stage = "Couldn't enqueue kernel.";
+				err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &work_size, &local_size, 0, NULL, NULL);
+			}
+
+			if (err >= 0) {
+				*stage = "Couldn't read buffer.";
+				err = clEnqueueReadBuffer(queue, output_buffer, CL_TRUE, 0, sizeof(OutputStruct) * n, output + first, 0, NULL, NULL);
+				if (err >= 0 && first) {
+					offsetThreadIds(output + first, n, first, 0);
+				}
+			}
+			for (auto& chunk_arg : chunk_args)
+			{
+				if (err >= 0 && chunk_arg.each && chunk_arg.out) {
+					err = clEnqueueReadBuffer(queue, chunk_arg.buffer, CL_TRUE, 0, chunk_arg.size * n, chunk_arg.data + chunk_arg.size * first, 0, NULL, NULL);
+				}
+			}
+
+			if (err >= 0) {
+				*done = first + n;
+			}
+		}
+
+		for (auto& chunk_arg : chunk_args)
+		{
+			if (err >= 0 && !chunk_arg.each && chunk_arg.out) {
+				*stage = "Couldn't read buffer.";
+				err = clEnqueueReadBuffer(queue, chunk_arg.buffer, CL_TRUE, 0, chunk_arg.size, chunk_arg.data, 0, NULL, NULL);
+			}
+		}
+
+		// the queue is drained before buffers it may still be using go
+		clFinish(queue);
+		releaseChunkArgs(chunk_args);
+		if (output_buffer) {
+			clReleaseMemObject(output_buffer);
+		}
+		if (input_buffer) {
+			clReleaseMemObject(input_buffer);
+		}
+		return err;
+	}
+
+	cl_command_queue residentQueue()
+	{
+		if (!resident_queue) {
+			int err;
+			resident_queue = clCreateCommandQueue(context, device, 0, &err);
+			if (err < 0) {
+				resident_queue = NULL;
+				throw std::exception("Couldn't create a command queue.");
+			}
+		}
+		return resident_queue;
+	}
+
+	cl_kernel residentKernel(const char *kernalName)
+	{
+		auto found = resident_kernels.find(kernalName);
+		if (found != resident_kernels.end()) {
+			return found->second;
+		}
+
+		int err;
+		cl_kernel kernel = clCreateKernel(program, kernalName, &err);
+		if (err < 0) {
+			throw std::exception("Couldn't create a kernal.");
+		}
+		resident_kernels[kernalName] = kernel;
+		return kernel;
+	}
+
+	// the first platform and its first device of gpu_type, as every program is built on
+	static void find_device(int gpu_type, cl_platform_id& _platform, cl_device_id& _device)
+	{
+		int err;
+		/* Identify a platform */
+		err = clGetPlatformIDs(1, &_platform, NULL);
+		if (err < 0) {
+			throw std::exception("Couldn't identify a platform");
+		}
+
+		/* Access a device */
+		err = clGetDeviceIDs(_platform, gpu_type, 1, &_device, NULL);
+		if (err < 0) {
+			throw std::exception("Couldn't identify a GPU");
+		}
+	}
+
+	void open(int gpu_type)
+	{
+		int err;
+		find_device(gpu_type, platform, device);
+
+		context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+		if (err < 0) {
+			clReleaseDevice(device);
+			throw std::exception("Couldn't create a context");
+		}
+
+		if (clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(max_alloc), &max_alloc, NULL) < 0) {
+			max_alloc = 0;
+		}
+		if (clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(global_mem), &global_mem, NULL) < 0) {
+			global_mem = 0;
+		}
+		if (clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(compute_units), &compute_units, NULL) < 0 || !compute_units) {
+			compute_units = 1;
+		}
+		chunk_limit = 0;
+		last_chunk = 0;
+		resident_queue = NULL;
+	}
+
+	// the device and context of share, held for this program too
+	void open(const openClProgram& share)
+	{
+		platform = share.platform;
+		device = share.device;
+		context = share.context;
+		clRetainDevice(device);
+		clRetainContext(context);
+
+		max_alloc = share.max_alloc;
+		global_mem = share.global_mem;
+		compute_units = share.compute_units;
+		chunk_limit = 0;
+		last_chunk = 0;
+		resident_queue = NULL;
+	}
+
+	void compile(const char *build_options)
+	{
+		int err = clBuildProgram(program, 0, NULL, build_options, NULL, NULL);
+		if (err < 0) {
+
+			size_t log_size;
+			/* Find size of log and print to std output */
+			clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);			
+			char *program_log = (char*)malloc(log_size + 1);
+			program_log[log_size] = '\0';
+			clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, log_size + 1, program_log, NULL);
+			std::string plog = program_log;
+			free(program_log);
+
+			clReleaseProgram(program);
+			clReleaseContext(context);
+			clReleaseDevice(device);
+			throw std::exception(plog.c_str());
+		}
+	}
+
+	void build(const char **program_buffers, cl_uint program_count, const char *build_options)
+	{
+		int err;
+
+		program = clCreateProgramWithSource(context, program_count, program_buffers, NULL, &err);
+		if (err < 0) {
+			clReleaseContext(context);
+			clReleaseDevice(device);
+			throw std::exception("Couldn't create program");
+		}
+
+		compile(build_options);
+	}
+
+	void build(const unsigned char *binary, size_t binary_size, const char *build_options)
+	{
+		int err, binary_status;
+
+		program = clCreateProgramWithBinary(context, 1, &device, &binary_size, &binary, &binary_status, &err);
+		if (err < 0 || binary_status < 0) {
+			if (err >= 0) {
+				clReleaseProgram(program);
+			}
+			clReleaseContext(context);
+			clReleaseDevice(device);
+			throw std::exception("Couldn't load program binary");
+		}
+
+		compile(build_options);
+	}
+
+public:
+
+	INPUT input;
+	OUTPUT output;
+
+	/* build_options is handed to clBuildProgram, as in "-cl-fast-relaxed-math".
+	Options apply to the whole program, so sources built with different options
+	need their own openClProgram. */
+	openClProgram(const char *program_buffer, int gpu_type = CL_DEVICE_TYPE_GPU, const char *build_options = NULL)
+	{
+		open(gpu_type);
+		build(&program_buffer, 1, build_options);
+	}
+
+	/* A program built from several sources compiled as one, for instance
+	openClReduceSource ahead of the kernels that use it. */
+	openClProgram(const char **program_buffers, cl_uint program_count, int gpu_type = CL_DEVICE_TYPE_GPU, const char *build_options = NULL)
+	{
+		open(gpu_type);
+		build(program_buffers, program_count, build_options);
+	}
+
+	/* A program from the bytes GetBinary returned for the same device and
+	driver, which skips compiling the source.  A binary the device will not
+	take throws, and the caller builds from source instead. */
+	openClProgram(const unsigned char *binary, size_t binary_size, int gpu_type = CL_DEVICE_TYPE_GPU, const char *build_options = NULL)
+	{
+		open(gpu_type);
+		build(binary, binary_size, build_options);
+	}
+
+	/* The same, built on the device and context of share rather than a
+	context of their own, for the many builds of one source that variants
+	with different options are.  Each program still finishes only its own
+	RunResident launches before another launch reads a dataset, so a dataset
+	is best passed only to the program that made it. */
+	openClProgram(const openClProgram& share, const char **program_buffers, cl_uint program_count, const char *build_options = NULL)
+	{
+		open(share);
+		build(program_buffers, program_count, build_options);
+	}
+
+	openClProgram(const openClProgram& share, const unsigned char *binary, size_t binary_size, const char *build_options = NULL)
+	{
+		open(share);
+		build(binary, binary_size, build_options);
+	}
+
+	virtual ~openClProgram()
+	{
+		for (auto& resident_kernel : resident_kernels)
+		{
+			clReleaseKernel(resident_kernel.second);
+		}
+		if (resident_queue) {
+			clFinish(resident_queue);
+			clReleaseCommandQueue(resident_queue);
+		}
+		clReleaseProgram(program);
+		clReleaseContext(context);
+		clReleaseDevice(device);
+	}
+
+	/* A string the device a program for gpu_type would be built on reports, as
+	CL_DEVICE_NAME or CL_DRIVER_VERSION, without building one; empty when the
+	device will not say.  Saved binaries are keyed on these. */
+	static std::string GetDeviceString(cl_device_info name, int gpu_type = CL_DEVICE_TYPE_GPU)
+	{
+		cl_platform_id found_platform;
+		cl_device_id found_device;
+		find_device(gpu_type, found_platform, found_device);
+
+		std::string value;
+		size_t size = 0;
+		if (clGetDeviceInfo(found_device, name, 0, NULL, &size) >= 0 && size) {
+			std::vector<char> text(size + 1, '\0');
+			if (clGetDeviceInfo(found_device, name, size, text.data(), NULL) >= 0) {
+				value = text.data();
+			}
+		}
+		clReleaseDevice(found_device);
+		return value;
+	}
+
+	// the compiled program for the device, to be saved and handed to the binary constructor later
+	std::vector<unsigned char> GetBinary()
+	{
+		size_t binary_size = 0;
+		int err = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(binary_size), &binary_size, NULL);
+		if (err < 0 || !binary_size) {
+			throw std::exception("Couldn't get program binary size.");
+		}
+
+		std::vector<unsigned char> binary(binary_size);
+		unsigned char *binaries[1] = { binary.data() };
+		err = clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries), binaries, NULL);
+		if (err < 0) {
+			throw std::exception("Couldn't get program binary.");
+		}
+		return binary;
+	}
+
+	/* Runs input_size requests, local_size work items each, request i
+	writing output[i].  A batch larger than the device will hold is cut into
+	the largest chunks that fit, see chunkSize, run one after another through
+	the same buffers.  When the first chunk fails for want of memory or
+	resources the device was more pressed than its limits said, and the call
+	starts over with chunks half the size; once a chunk has come back the size
+	is known to fit and any later error throws.  Arrays passed whole that no
+	chunk size can make room for throw before anything is uploaded. */
+	template <class InputStruct, class OutputStruct, class... Args> bool RunKernel(const char *kernalName, InputStruct *input, OutputStruct *output, size_t input_size = 1, size_t local_size = 1, const Args&... args)
+	{
+		std::vector<openClChunkArg> chunk_args;
+		cl_command_queue queue;
+		cl_kernel kernel;
+		const char *stage = "Couldn't create kernel argument.";
+		size_t done = 0;
+		int err;
+
+		if (!input_size) {
+			return true;
+		}
+
+		waitForDatasets(args...);
+
+		queue = clCreateCommandQueue(context, device, 0, &err);
+		if (err < 0) {
+			throw std::exception("Couldn't create a command queue.");
+		};
+
+		kernel = clCreateKernel(program, kernalName, &err);
+		if (err < 0) {
+			clReleaseCommandQueue(queue);
+			throw std::exception("Couldn't create a kernal.");
+		};
+
+		err = describeArgs(kernel, 2, chunk_args, args...);
+
+		const char *misfit = err >= 0 ? wholeArgsMisfit(chunk_args) : NULL;
+		if (misfit) {
+			clReleaseKernel(kernel);
+			clReleaseCommandQueue(queue);
+			throw std::exception(misfit);
+		}
+
+		size_t chunk = chunkSize(sizeof(InputStruct), sizeof(OutputStruct), chunk_args, input_size, local_size);
+		while (err >= 0)
+		{
+			last_chunk = chunk;
+			err = runChunks(queue, kernel, input, output, input_size, local_size, chunk, chunk_args, &done, &stage);
+
+			bool pressed = err == CL_MEM_OBJECT_ALLOCATION_FAILURE || err == CL_OUT_OF_RESOURCES || err == CL_OUT_OF_HOST_MEMORY || err == CL_INVALID_BUFFER_SIZE;
+			if (err >= 0 || !pressed || done || chunk == 1) {
+				break;
+			}
+			chunk = (chunk + 1) / 2;
+			err = CL_SUCCESS;
+		}
+
+		clReleaseKernel(kernel);
+		clReleaseCommandQueue(queue);
+
+		if (err < 0) {
+			throw std::exception(stage);
+		}
+		return true;
+	}
 
-public:
+	/* Caps the requests in a RunKernel chunk below what the device limits
+	allow, 0 for no cap. */
+	void SetChunkLimit(size_t requests)
+	{
+		chunk_limit = requests;
+	}
 
-	INPUT input;
-	OUTPUT output;
+	// a dataset of count elements holding a copy of data
+	template <class T> openClDataset<T> Upload(const T *data, size_t count)
+	{
+		int err;
+		cl_mem buffer = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(T) * count, (void *)data, &err);
+		if (err < 0) {
+			throw std::exception("Couldn't create dataset buffer.");
+		}
+		return openClDataset<T>(buffer, count, context);
+	}
 
-	openClProgram(const char *program_buffer, int gpu_type = CL_DEVICE_TYPE_GPU)
+	// a dataset of count elements for a launch to fill
+	template <class T> openClDataset<T> Allocate(size_t count)
 	{
 		int err;
-		/* Identify a platform */
-		err = clGetPlatformIDs(1, &platform, NULL);
+		cl_mem buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(T) * count, NULL, &err);
 		if (err < 0) {
-			throw std::exception("Couldn't identify a platform");
+			throw std::exception("Couldn't create dataset buffer.");
 		}
+		return openClDataset<T>(buffer, count, context);
+	}
 
-		/* Access a device */
-		err = clGetDeviceIDs(platform, gpu_type, 1, &device, NULL);
+	/* Copies count elements of a dataset from first into data, once the
+	launches queued ahead of it have run.  count 0 is the rest of the dataset. */
+	template <class T> void Download(const openClDataset<T>& dataset, T *data, size_t first = 0, size_t count = 0)
+	{
+		if (!count) {
+			count = dataset.count - first;
+		}
+
+		int err = clEnqueueReadBuffer(residentQueue(), dataset.buffer, CL_TRUE, sizeof(T) * first, sizeof(T) * count, data, 0, NULL, NULL);
 		if (err < 0) {
-			throw std::exception("Couldn't identify a GPU");
+			throw std::exception("Couldn't read buffer.");
 		}
+	}
 
-		context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+	/* Launches work_size work items with args bound from the kernel's first
+	parameter: datasets by their buffer, openClIn and openClOut arrays
+	uploaded for this launch alone, anything else by value.  Launches are
+	queued in order and the call returns without waiting, unless an openClOut
+	has to be read back; Download waits for what it reads, and the other Run
+	calls given a dataset wait for every launch queued here.  Nothing is cut
+	into chunks, so the datasets must fit on the device. */
+	template <class... Args> void RunResident(const char *kernalName, size_t work_size, const Args&... args)
+	{
+		std::vector<openClBinding> bindings;
+		cl_command_queue queue = residentQueue();
+		cl_kernel kernel = residentKernel(kernalName);
+		int err;
+
+		if (!work_size) {
+			return;
+		}
+
+		// the resident queue is in order, so only where the datasets come from is checked
+		checkDatasets(args...);
+
+		try
+		{
+			bindArgs(kernel, 0, bindings, args...);
+		}
+		catch (std::exception&)
+		{
+			releaseBindings(bindings);
+			throw;
+		}
+
+		err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &work_size, NULL, 0, NULL, NULL);
+		for (auto& binding : bindings)
+		{
+			if (binding.readback && err >= 0) {
+				err = clEnqueueReadBuffer(queue, binding.buffer, CL_TRUE, 0, binding.size, binding.readback, 0, NULL, NULL);
+			}
+		}
+
+		// a buffer released here is kept by the runtime until the launch using it is done
+		releaseBindings(bindings);
 		if (err < 0) {
-			clReleaseDevice(device);
-			throw std::exception("Couldn't create a context");
+			throw std::exception("Couldn't enqueue kernel.");
 		}
+	}
 
-		size_t program_size = strlen(program_buffer);
+	// the chunk size the last RunKernel settled on
+	size_t GetLastChunk() const
+	{
+		return last_chunk;
+	}
+
+	/* The work group the reduction and compaction kernels run in:
+	openClReduceGroup, halved until the device takes kernalName in groups
+	that large.  The reductions halve the group as they go, so it stays a
+	power of 2. */
+	size_t GetReduceGroup(const char *kernalName)
+	{
+		size_t limit = openClReduceGroup, local_size = openClReduceGroup;
+		int err;
 
-		program = clCreateProgramWithSource(context, 1, (const char**)&program_buffer, &program_size, &err);
+		cl_kernel kernel = clCreateKernel(program, kernalName, &err);
 		if (err < 0) {
-			clReleaseContext(context);
-			clReleaseDevice(device);
-			throw std::exception("Couldn't create program");
+			throw std::exception("Couldn't create a kernal.");
 		}
 
-		err = clBuildProgram(program, 0, NULL, NULL, NULL, NULL);
+		err = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(limit), &limit, NULL);
+		clReleaseKernel(kernel);
 		if (err < 0) {
+			throw std::exception("Couldn't get the kernel's work group size.");
+		}
 
-			size_t log_size;
-			/* Find size of log and print to std output */
-			clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);			
-			char *program_log = (char*)malloc(log_size + 1);
-			program_log[log_size] = '\0';
-			clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, log_size + 1, program_log, NULL);
-			std::string plog = program_log;
-			free(program_log);
+		while (local_size > 1 && local_size > limit) {
+			local_size /= 2;
+		}
+		return local_size;
+	}
 
-			clReleaseProgram(program);
-			clReleaseContext(context);
-			clReleaseDevice(device);
-			throw std::exception(plog.c_str());
+	/* How many groups of local_size a reduction over input_size inputs runs:
+	one input an item, up to openClReduceGroupsPerUnit groups a compute
+	unit. */
+	size_t GetReduceGroups(size_t input_size, size_t local_size) const
+	{
+		size_t groups = (input_size + local_size - 1) / local_size;
+		return std::min(groups, openClReduceGroupsPerUnit * compute_units);
+	}
+
+	/* Runs a reduction kernel over input_size inputs in GetReduceGroups
+	groups of GetReduceGroup work items.  The kernel is called as
+	kernel(input, partials, (ulong)input_size, args...); each item folds the
+	inputs from its global id on in steps of the global size, and each group
+	writes one PartialStruct.  Only the partials are read back, a few
+	kilobytes at any input size, and the host folds them with combine,
+	starting from identity. */
+	template <class InputStruct, class PartialStruct, class Combine, class... Args> PartialStruct RunReduce(const char *kernalName, InputStruct *input, size_t input_size, const PartialStruct& identity, Combine combine, const Args&... args)
+	{
+		size_t local_size = GetReduceGroup(kernalName);
+		size_t groups = GetReduceGroups(input_size, local_size);
+		size_t global_size = groups * local_size;
+		PartialStruct result = identity;
+
+		if (!groups) {
+			return result;
+		}
+
+		std::vector<PartialStruct> partials(groups, identity);
+		RunKernelRange(kernalName, input, input_size, partials.data(), groups, 1, &global_size, &local_size, (cl_ulong)input_size, args...);
+
+		for (auto& partial : partials)
+		{
+			result = combine(result, partial);
 		}
+		return result;
 	}
 
-	virtual ~openClProgram()
+	/* Runs a compaction kernel over input_size inputs, an item each, in
+	groups of GetReduceGroup work items.  The kernel is called as
+	kernel(input, hits, hit_count, (ulong)input_size, args...), with hits
+	room for input_size HitStruct and hit_count a single uint, as
+	compact_slot fills them.  The count is read back first and then only that
+	many hits, which are appended to hits.  Returns the number appended. */
+	template <class InputStruct, class HitStruct, class... Args> size_t RunCompact(const char *kernalName, InputStruct *input, size_t input_size, std::vector<HitStruct>& hits, const Args&... args)
 	{
-		clReleaseProgram(program);
-		clReleaseContext(context);
-		clReleaseDevice(device);
+		static_assert(std::is_pod<HitStruct>::value, "HitStruct must be plain old data.");
+
+		std::vector<openClBinding> bindings;
+		cl_command_queue queue;
+		cl_kernel kernel;
+		cl_uint hit_count = 0;
+		int err;
+
+		if (!input_size) {
+			return 0;
+		}
+
+		size_t local_size = GetReduceGroup(kernalName);
+		size_t global_size = (input_size + local_size - 1) / local_size * local_size;
+
+		waitForDatasets(args...);
+
+		queue = clCreateCommandQueue(context, device, 0, &err);
+		if (err < 0) {
+			throw std::exception("Couldn't create a command queue.");
+		};
+
+		kernel = clCreateKernel(program, kernalName, &err);
+		if (err < 0) {
+			clReleaseCommandQueue(queue);
+			throw std::exception("Couldn't create a kernal.");
+		};
+
+		auto input_buffer = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, sizeof(InputStruct) * input_size, input, &err);
+		if (err < 0) {
+			clReleaseKernel(kernel);
+			clReleaseCommandQueue(queue);
+			throw std::exception("Couldn't input buffer.");
+		};
+
+		// nothing to copy in, the kernel only writes the slots it reserves
+		auto hits_buffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY, sizeof(HitStruct) * input_size, NULL, &err);
+		if (err < 0) {
+			clReleaseKernel(kernel);
+			clReleaseMemObject(input_buffer);
+			clReleaseCommandQueue(queue);
+			throw std::exception("Couldn't create output buffer.");
+		};
+
+		auto count_buffer = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(cl_uint), &hit_count, &err);
+		if (err < 0) {
+			clReleaseKernel(kernel);
+			clReleaseMemObject(hits_buffer);
+			clReleaseMemObject(input_buffer);
+			clReleaseCommandQueue(queue);
+			throw std::exception("Couldn't create output buffer.");
+		};
+
+		err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &input_buffer);
+		err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &hits_buffer);
+		err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &count_buffer);
+		if (err < 0) {
+			clReleaseKernel(kernel);
+			clReleaseMemObject(count_buffer);
+			clReleaseMemObject(hits_buffer);
+			clReleaseMemObject(input_buffer);
+			clReleaseCommandQueue(queue);
+			throw std::exception("Couldn't create kernel argument.");
+		}
+
+		try
+		{
+			bindArgs(kernel, 3, bindings, (cl_ulong)input_size, args...);
+		}
+		catch (std::exception&)
+		{
+			releaseBindings(bindings);
+			clReleaseKernel(kernel);
+			clReleaseMemObject(count_buffer);
+			clReleaseMemObject(hits_buffer);
+			clReleaseMemObject(input_buffer);
+			clReleaseCommandQueue(queue);
+			throw;
+		}
+
+		err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+		if (err >= 0) {
+			err = clEnqueueReadBuffer(queue, count_buffer, CL_TRUE, 0, sizeof(cl_uint), &hit_count, 0, NULL, NULL);
+		}
+
+		size_t first = hits.size();
+		if (err >= 0 && hit_count) {
+			hits.resize(first + hit_count);
+			err = clEnqueueReadBuffer(queue, hits_buffer, CL_TRUE, 0, sizeof(HitStruct) * hit_count, &hits[first], 0, NULL, NULL);
+		}
+
+		releaseBindings(bindings);
+		clReleaseKernel(kernel);
+		clReleaseMemObject(count_buffer);
+		clReleaseMemObject(hits_buffer);
+		clReleaseMemObject(input_buffer);
+		clReleaseCommandQueue(queue);
+
+		if (err < 0) {
+			hits.resize(first);
+			throw std::exception("Couldn't read buffer.");
+		}
+
+		return hit_count;
 	}
 
-	template <class InputStruct, class OutputStruct> bool RunKernel(const char *kernalName, InputStruct *input, OutputStruct *output, size_t input_size = 1, size_t local_size = 1)
+	/* RunKernel with the buffer sizes and the NDRange given separately, for
+	kernels that do not map one input to one output, such as a grid
+	description expanded on the device into a 2D or 3D range of results.
+	local_size may be NULL to let the runtime pick work groups.  The output
+	buffer is only read back, never uploaded, so the kernel must write every
+	element of it. */
+	template <class InputStruct, class OutputStruct, class... Args> bool RunKernelRange(const char *kernalName, InputStruct *input, size_t input_size, OutputStruct *output, size_t output_size, cl_uint work_dim, const size_t *global_size, const size_t *local_size, const Args&... args)
 	{
+		std::vector<openClBinding> bindings;
 		cl_command_queue queue;
 		cl_kernel kernel;
 		int err;
 
+		waitForDatasets(args...);
+
 		/* Create a command queue */
 		queue = clCreateCommandQueue(context, device, 0, &err);
 		if (err < 0) {
@@ -104,7 +1304,7 @@ public:
 			throw std::exception("Couldn't input buffer.");
 		};
 
-		auto output_buffer = clCreateBuffer(context, CL_MEM_READ_WRITE |CL_MEM_COPY_HOST_PTR, sizeof(OutputStruct) * input_size, output, &err);
+		auto output_buffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY, sizeof(OutputStruct) * output_size, NULL, &err);
 		if (err < 0) {
 			clReleaseKernel(kernel);
 			clReleaseMemObject(input_buffer);
@@ -123,11 +1323,25 @@ public:
 			throw std::exception("Couldn't create kernel argument.");
 		}
 
+		try
+		{
+			bindArgs(kernel, 2, bindings, args...);
+		}
+		catch (std::exception&)
+		{
+			releaseBindings(bindings);
+			clReleaseKernel(kernel);
+			clReleaseMemObject(output_buffer);
+			clReleaseMemObject(input_buffer);
+			clReleaseCommandQueue(queue);
+			throw;
+		}
+
 		/* Enqueue kernel */
-		size_t work_size = input_size * local_size;
-		err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &work_size,
-			&local_size, 0, NULL, NULL);
+		err = clEnqueueNDRangeKernel(queue, kernel, work_dim, NULL, global_size,
+			local_size, 0, NULL, NULL);
 		if (err < 0) {
+			releaseBindings(bindings);
 			clReleaseKernel(kernel);
 			clReleaseMemObject(output_buffer);
 			clReleaseMemObject(input_buffer);
@@ -137,8 +1351,15 @@ public:
 
 		/* Read the kernel's output */
 		err = clEnqueueReadBuffer(queue, output_buffer, CL_TRUE, 0,
-			sizeof(OutputStruct)* input_size, output, 0, NULL, NULL);
+			sizeof(OutputStruct)* output_size, output, 0, NULL, NULL);
+		for (auto& binding : bindings)
+		{
+			if (binding.readback && err >= 0) {
+				err = clEnqueueReadBuffer(queue, binding.buffer, CL_TRUE, 0, binding.size, binding.readback, 0, NULL, NULL);
+			}
+		}
 		if (err < 0) {
+			releaseBindings(bindings);
 			clReleaseKernel(kernel);
 			clReleaseMemObject(output_buffer);
 			clReleaseMemObject(input_buffer);
@@ -147,10 +1368,332 @@ public:
 		}
 
 		/* Deallocate resources */
+		releaseBindings(bindings);
 		clReleaseKernel(kernel);
 		clReleaseMemObject(output_buffer);
 		clReleaseMemObject(input_buffer);
 		clReleaseCommandQueue(queue);
+
+		return true;
+	}
+
+};
+
+/* A fixed set of launches and transfers over datasets of one openClProgram,
+built once and run for batch after batch.  Each node names the nodes it
+waits for, which must have been added before it, and Run enqueues every
+node with the events of those nodes as its wait list and blocks only once,
+when the whole graph is queued, so the host never stops between launches
+and kernels that do not wait on each other can overlap on the device.
+
+Nodes go on one out of order queue when the device has one.  Otherwise they
+are spread over lanes in order queues: a node follows the first of its
+dependencies onto that one's queue, and a second node waiting on the same
+dependency, or a node waiting on none, takes the queue with the fewest
+nodes so far.
+
+Kernel arguments are bound when the node is added: datasets by their
+buffer, openClIn arrays uploaded once and kept for the graph's life,
+anything else by value, which SetArg can change between runs.  openClOut
+has nothing to read back into and is refused; read a dataset instead.
+Write and Read copy a whole dataset from or to host memory given when the
+node is added, or later with SetData, which must stay put until Run
+returns.  A transfer given NULL, or a launch of no work items, does nothing
+but pass its dependencies on.
+
+The datasets must be made by the program, and outlive the graph, and the
+graph the program. */
+
+template <class INPUT, class OUTPUT> class openClGraph
+{
+	typedef openClProgram<INPUT, OUTPUT> graph_program;
+	typedef typename graph_program::openClBinding graph_binding;
+
+	enum node_kind
+	{
+		graph_kernel,
+		graph_write,
+		graph_read
+	};
+
+	struct node
+	{
+		node_kind kind;
+		cl_kernel kernel;
+		cl_mem buffer;
+		void *data;
+		size_t size;
+		size_t work_size;
+		size_t local_size;
+		std::vector<size_t> after;
+		size_t lane;
+		bool followed;
+	};
+
+	graph_program& program;
+	std::vector<cl_command_queue> lanes;
+	std::vector<size_t> lane_nodes;
+	std::vector<node> nodes;
+	std::vector<graph_binding> tables;
+	std::vector<cl_event> events;
+	std::vector<cl_event> waits;
+
+	size_t add(node_kind kind, std::initializer_list<size_t> after)
+	{
+		node added;
+		added.kind = kind;
+		added.kernel = NULL;
+		added.buffer = NULL;
+		added.data = NULL;
+		added.size = 0;
+		added.work_size = 0;
+		added.local_size = 0;
+		added.after.assign(after.begin(), after.end());
+		added.followed = false;
+
+		added.lane = lanes.size();
+		for (auto dependency : added.after)
+		{
+			if (dependency >= nodes.size()) {
+				throw std::exception("A graph node can only wait for nodes added before it.");
+			}
+			if (added.lane == lanes.size() && !nodes[dependency].followed) {
+				nodes[dependency].followed = true;
+				added.lane = nodes[dependency].lane;
+			}
+		}
+		if (added.lane == lanes.size()) {
+			added.lane = std::min_element(lane_nodes.begin(), lane_nodes.end()) - lane_nodes.begin();
+		}
+		lane_nodes[added.lane]++;
+
+		nodes.push_back(added);
+		return nodes.size() - 1;
+	}
+
+	void releaseEvents()
+	{
+		for (auto& event : events)
+		{
+			if (event) {
+				clReleaseEvent(event);
+			}
+		}
+		events.clear();
+	}
+
+public:
+
+	// lane_count is how many in order queues stand in when there is no out of order one
+	openClGraph(graph_program& _program, size_t lane_count = 4) : program(_program)
+	{
+		cl_command_queue_properties supported = 0;
+		cl_command_queue_properties properties = 0;
+		int err;
+
+		if (clGetDeviceInfo(program.device, CL_DEVICE_QUEUE_PROPERTIES, sizeof(supported), &supported, NULL) >= 0 && (supported & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
+			properties = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+			lane_count = 1;
+		}
+
+		for (size_t i = 0; i < std::max<size_t>(lane_count, 1); i++)
+		{
+			cl_command_queue queue = clCreateCommandQueue(program.context, program.device, properties, &err);
+			if (err < 0) {
+				for (auto lane : lanes)
+				{
+					clReleaseCommandQueue(lane);
+				}
+				throw std::exception("Couldn't create a command queue.");
+			}
+			lanes.push_back(queue);
+		}
+		lane_nodes.assign(lanes.size(), 0);
+	}
+
+	openClGraph(const openClGraph&) = delete;
+	openClGraph& operator = (const openClGraph&) = delete;
+
+	virtual ~openClGraph()
+	{
+		for (auto lane : lanes)
+		{
+			clFinish(lane);
+		}
+		releaseEvents();
+		for (auto& added : nodes)
+		{
+			if (added.kernel) {
+				clReleaseKernel(added.kernel);
+			}
+		}
+		program.releaseBindings(tables);
+		for (auto lane : lanes)
+		{
+			clReleaseCommandQueue(lane);
+		}
+	}
+
+	// a copy of data into all of dataset
+	template <class T> size_t Write(openClDataset<T>& dataset, const T *data, std::initializer_list<size_t> after = {})
+	{
+		program.checkDatasets(dataset);
+		size_t added = add(graph_write, after);
+		nodes[added].buffer = dataset.buffer;
+		nodes[added].data = (void *)data;
+		nodes[added].size = sizeof(T) * dataset.count;
+		return added;
+	}
+
+	// a copy of all of dataset into data
+	template <class T> size_t Read(const openClDataset<T>& dataset, T *data, std::initializer_list<size_t> after = {})
+	{
+		program.checkDatasets(dataset);
+		size_t added = add(graph_read, after);
+		nodes[added].buffer = dataset.buffer;
+		nodes[added].data = (void *)data;
+		nodes[added].size = sizeof(T) * dataset.count;
+		return added;
+	}
+
+	/* A launch of work_size work items in groups of local_size, 0 to leave the
+	groups to the runtime, with args bound from the kernel's first parameter.
+	Each node has a kernel object of its own, so a kernel can appear in the
+	graph more than once with different arguments. */
+	template <class... Args> size_t Kernel(const char *kernalName, size_t work_size, size_t local_size, std::initializer_list<size_t> after, const Args&... args)
+	{
+		std::vector<graph_binding> bindings;
+		int err;
+
+		program.checkDatasets(args...);
+
+		cl_kernel kernel = clCreateKernel(program.program, kernalName, &err);
+		if (err < 0) {
+			throw std::exception("Couldn't create a kernal.");
+		}
+
+		try
+		{
+			program.bindArgs(kernel, 0, bindings, args...);
+			for (auto& binding : bindings)
+			{
+				if (binding.readback) {
+					throw std::exception("A graph reads back datasets, not openClOut arrays.");
+				}
+			}
+		}
+		catch (std::exception&)
+		{
+			program.releaseBindings(bindings);
+			clReleaseKernel(kernel);
+			throw;
+		}
+
+		tables.insert(tables.end(), bindings.begin(), bindings.end());
+
+		size_t added;
+		try
+		{
+			added = add(graph_kernel, after);
+		}
+		catch (std::exception&)
+		{
+			clReleaseKernel(kernel);
+			throw;
+		}
+		nodes[added].kernel = kernel;
+		nodes[added].work_size = work_size;
+		nodes[added].local_size = local_size;
+		return added;
 	}
 
+	// the host memory a Write or Read node copies from or to on the next Run
+	template <class T> void SetData(size_t transfer, T *data)
+	{
+		if (transfer >= nodes.size() || nodes[transfer].kind == graph_kernel) {
+			throw std::exception("SetData takes a Write or Read node.");
+		}
+		nodes[transfer].data = (void *)data;
+	}
+
+	// a by value argument of a Kernel node, from the next Run on
+	template <class T> void SetArg(size_t launch, cl_uint index, const T& value)
+	{
+		if (launch >= nodes.size() || nodes[launch].kind != graph_kernel) {
+			throw std::exception("SetArg takes a Kernel node.");
+		}
+		if (clSetKernelArg(nodes[launch].kernel, index, sizeof(T), &value) < 0) {
+			throw std::exception("Couldn't create kernel argument.");
+		}
+	}
+
+	/* Queues the whole graph and waits for it, once the program's RunResident
+	launches are done.  A node that cannot be queued stops the run: what was
+	queued is finished, and then Run throws. */
+	void Run()
+	{
+		int err = CL_SUCCESS;
+
+		program.finishResident();
+
+		events.assign(nodes.size(), NULL);
+		for (size_t i = 0; i < nodes.size() && err >= 0; i++)
+		{
+			node& current = nodes[i];
+			cl_command_queue queue = lanes[current.lane];
+
+			waits.clear();
+			for (auto dependency : current.after)
+			{
+				waits.push_back(events[dependency]);
+			}
+			cl_uint wait_count = (cl_uint)waits.size();
+			const cl_event *wait_list = waits.empty() ? NULL : waits.data();
+
+			if (current.kind == graph_kernel && current.work_size) {
+				err = clEnqueueNDRangeKernel(queue, current.kernel, 1, NULL, &current.work_size, current.local_size ? &current.local_size : NULL, wait_count, wait_list, &events[i]);
+			}
+			else if (current.kind == graph_kernel || !current.data || !current.size) {
+				err = clEnqueueMarkerWithWaitList(queue, wait_count, wait_list, &events[i]);
+			}
+			else if (current.kind == graph_write) {
+				err = clEnqueueWriteBuffer(queue, current.buffer, CL_FALSE, 0, current.size, current.data, wait_count, wait_list, &events[i]);
+			}
+			else {
+				err = clEnqueueReadBuffer(queue, current.buffer, CL_FALSE, 0, current.size, current.data, wait_count, wait_list, &events[i]);
+			}
+		}
+
+		// a queue waiting on another's events needs that queue flushed to get going
+		for (auto lane : lanes)
+		{
+			clFlush(lane);
+		}
+
+		if (err >= 0 && !events.empty()) {
+			err = clWaitForEvents((cl_uint)events.size(), events.data());
+		}
+		if (err < 0) {
+			for (auto lane : lanes)
+			{
+				clFinish(lane);
+			}
+		}
+		releaseEvents();
+
+		if (err < 0) {
+			throw std::exception("Couldn't run graph.");
+		}
+	}
+
+	// how many nodes there are, and how many queues they are spread over
+	size_t GetNodeCount() const
+	{
+		return nodes.size();
+	}
+
+	size_t GetLaneCount() const
+	{
+		return lanes.size();
+	}
 };
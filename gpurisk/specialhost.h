@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+
+#include "openclhost.h"
+#include "file_data.h"
+#include "gslsource.h"
+
+/* The one argument special functions gslspecial.cl has kernels for. */
+enum special_function
+{
+	special_psi,
+	special_psi_1,
+	special_erfc,
+	special_lngamma,
+	special_function_count
+};
+
+/* special_engine runs batches of the gslbeta.cl special functions, digamma,
+trigamma, psi^(n), the Hurwitz zeta, erfc and ln gamma, for calibration code
+that would otherwise make millions of scalar gslport.h calls.  Batches are
+structure of arrays: each argument is its own array of count values, and
+values come back in an array of the same length.  gsl::gsl_sf_psi_array and
+friends are the CPU side of the same layout. */
+class special_engine
+{
+	typedef openClProgram<double, double> special_program;
+
+	int gpu_type;
+	std::unique_ptr<special_program> special_cl;
+
+	special_program& program()
+	{
+		if (!special_cl) {
+			gsl_source gsl;
+			io::file_data special("gslspecial.cl");
+			const char *sources[2] = { gsl.get_data(), special.get_data() };
+			special_cl.reset(new special_program(sources, 2, gpu_type));
+		}
+		return *special_cl;
+	}
+
+public:
+
+	special_engine(int _gpu_type = CL_DEVICE_TYPE_GPU) : gpu_type(_gpu_type)
+	{
+		;
+	}
+
+	// builds the program ahead of the first batch so the build is not timed with it
+	void prepare()
+	{
+		program();
+	}
+
+	void evaluate(special_function function, double *x, double *values, size_t count)
+	{
+		static const char *kernels[special_function_count] = { "gsl_sf_psi_cl", "gsl_sf_psi_1_cl", "gsl_sf_erfc_cl", "gsl_sf_lngamma_cl" };
+
+		if (count) {
+			program().RunKernel(kernels[function], x, values, count, 1);
+		}
+	}
+
+	// psi^(order[i])(x[i])
+	void psi_n(int *order, double *x, double *values, size_t count)
+	{
+		if (count) {
+			program().RunKernel("gsl_sf_psi_n_cl", x, values, count, 1, openClInEach(order));
+		}
+	}
+
+	// zeta(s[i], q[i])
+	void hzeta(double *s, double *q, double *values, size_t count)
+	{
+		if (count) {
+			program().RunKernel("gsl_sf_hzeta_cl", s, values, count, 1, openClInEach(q));
+		}
+	}
+};
@@ -14,7 +14,17 @@
 #include <amp_math.h>  
 
 #include "openclhost.h"
+#include "gslsource.h"
 #include "ampbeta.h"
+#include "betacache.h"
+#include "betadedup.h"
+#include "betaparams.h"
+#include "betahost.h"
+#include "betagraph.h"
+#include "betacheb.h"
+#include "betaspec.h"
+#include "gammahost.h"
+#include "specialhost.h"
 
 #include "engine_benchmark.h"
 